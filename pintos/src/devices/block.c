@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include "devices/ide.h"
 #include "threads/malloc.h"
+#include "threads/thread.h"
 
 /* A block device. */
 struct block
@@ -120,9 +121,8 @@ check_sector (struct block *block, block_sector_t sector)
 void
 block_read (struct block *block, block_sector_t sector, void *buffer)
 {
-  check_sector (block, sector);
-  block->ops->read (block->aux, sector, buffer);
-  block->read_cnt++;
+  block_read_uncharged (block, sector, buffer);
+  thread_current ()->ru.sectors_read++;
 }
 
 /* Write sector SECTOR to BLOCK from BUFFER, which must contain
@@ -132,6 +132,31 @@ block_read (struct block *block, block_sector_t sector, void *buffer)
    per-block device locking is unneeded. */
 void
 block_write (struct block *block, block_sector_t sector, const void *buffer)
+{
+  block_write_uncharged (block, sector, buffer);
+  thread_current ()->ru.sectors_written++;
+}
+
+/* Like block_read(), but does not charge the sector to the
+   current thread's resource usage.  For a driver that stores its
+   sectors on another device, whose own read was already
+   charged. */
+void
+block_read_uncharged (struct block *block, block_sector_t sector,
+                      void *buffer)
+{
+  check_sector (block, sector);
+  block->ops->read (block->aux, sector, buffer);
+  block->read_cnt++;
+}
+
+/* Like block_write(), but does not charge the sector to the
+   current thread's resource usage.  For a driver that stores its
+   sectors on another device, whose own write was already
+   charged. */
+void
+block_write_uncharged (struct block *block, block_sector_t sector,
+                       const void *buffer)
 {
   check_sector (block, sector);
   ASSERT (block->type != BLOCK_FOREIGN);
@@ -139,6 +164,40 @@ block_write (struct block *block, block_sector_t sector, const void *buffer)
   block->write_cnt++;
 }
 
+/* Tells BLOCK that the CNT sectors starting at SECTOR no longer
+   hold useful data, so that it may release whatever backs them.
+   Their contents are unspecified until they are written again.
+   Does nothing for devices that have no use for the hint. */
+void
+block_discard (struct block *block, block_sector_t sector,
+               block_sector_t cnt)
+{
+  if (cnt == 0)
+    return;
+  check_sector (block, sector);
+  check_sector (block, sector + cnt - 1);
+  if (block->ops->discard != NULL)
+    block->ops->discard (block->aux, sector, cnt);
+}
+
+/* Asks BLOCK to set aside whatever it needs so that the CNT
+   sectors starting at SECTOR can all be written later, for
+   devices whose writes could otherwise run out of room.
+   Returns false if it cannot; the reservation is released by
+   block_discard() of the same sectors.  Always succeeds for
+   devices that have no use for it. */
+bool
+block_reserve (struct block *block, block_sector_t sector,
+               block_sector_t cnt)
+{
+  if (cnt == 0)
+    return true;
+  check_sector (block, sector);
+  check_sector (block, sector + cnt - 1);
+  return (block->ops->reserve == NULL
+          || block->ops->reserve (block->aux, sector, cnt));
+}
+
 /* Returns the number of sectors in BLOCK. */
 block_sector_t
 block_size (struct block *block)
@@ -1,6 +1,7 @@
 #ifndef DEVICES_BLOCK_H
 #define DEVICES_BLOCK_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <inttypes.h>
 
@@ -53,6 +54,8 @@ struct block *block_next (struct block *);
 block_sector_t block_size (struct block *);
 void block_read (struct block *, block_sector_t, void *);
 void block_write (struct block *, block_sector_t, const void *);
+void block_discard (struct block *, block_sector_t, block_sector_t cnt);
+bool block_reserve (struct block *, block_sector_t, block_sector_t cnt);
 const char *block_name (struct block *);
 enum block_type block_type (struct block *);
 
@@ -65,10 +68,16 @@ struct block_operations
   {
     void (*read) (void *aux, block_sector_t, void *buffer);
     void (*write) (void *aux, block_sector_t, const void *buffer);
+    /* Optional, may be null: see block_discard(). */
+    void (*discard) (void *aux, block_sector_t, block_sector_t cnt);
+    /* Optional, may be null: see block_reserve(). */
+    bool (*reserve) (void *aux, block_sector_t, block_sector_t cnt);
   };
 
 struct block *block_register (const char *name, enum block_type,
                               const char *extra_info, block_sector_t size,
                               const struct block_operations *, void *aux);
+void block_read_uncharged (struct block *, block_sector_t, void *);
+void block_write_uncharged (struct block *, block_sector_t, const void *);
 
 #endif /* devices/block.h */
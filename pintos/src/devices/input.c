@@ -2,6 +2,9 @@
 #include <debug.h>
 #include "devices/intq.h"
 #include "devices/serial.h"
+#ifdef USERPROG
+#include "userprog/poll.h"
+#endif
 
 /* Stores keys from the keyboard and serial port. */
 static struct intq buffer;
@@ -23,6 +26,9 @@ input_putc (uint8_t key)
 
   intq_putc (&buffer, key);
   serial_notify ();
+#ifdef USERPROG
+  poll_notify ();
+#endif
 }
 
 /* Retrieves a key from the input buffer.
@@ -41,6 +47,21 @@ input_getc (void)
   return key;
 }
 
+/* Returns true if a key can be retrieved without waiting,
+   false otherwise. */
+bool
+input_ready (void) 
+{
+  enum intr_level old_level;
+  bool ready;
+
+  old_level = intr_disable ();
+  ready = !intq_empty (&buffer);
+  intr_set_level (old_level);
+
+  return ready;
+}
+
 /* Returns true if the input buffer is full,
    false otherwise.
    Interrupts must be off. */
@@ -304,7 +304,7 @@ static void
 partition_read (void *p_, block_sector_t sector, void *buffer)
 {
   struct partition *p = p_;
-  block_read (p->block, p->start + sector, buffer);
+  block_read_uncharged (p->block, p->start + sector, buffer);
 }
 
 /* Write sector SECTOR to partition P from BUFFER, which must
@@ -314,11 +314,31 @@ static void
 partition_write (void *p_, block_sector_t sector, const void *buffer)
 {
   struct partition *p = p_;
-  block_write (p->block, p->start + sector, buffer);
+  block_write_uncharged (p->block, p->start + sector, buffer);
+}
+
+/* Passes a discard of CNT sectors at SECTOR in partition P on to
+   the underlying device. */
+static void
+partition_discard (void *p_, block_sector_t sector, block_sector_t cnt)
+{
+  struct partition *p = p_;
+  block_discard (p->block, p->start + sector, cnt);
+}
+
+/* Passes a reservation of CNT sectors at SECTOR in partition P
+   on to the underlying device. */
+static bool
+partition_reserve (void *p_, block_sector_t sector, block_sector_t cnt)
+{
+  struct partition *p = p_;
+  return block_reserve (p->block, p->start + sector, cnt);
 }
 
 static struct block_operations partition_operations =
   {
     partition_read,
-    partition_write
+    partition_write,
+    partition_discard,
+    partition_reserve
   };
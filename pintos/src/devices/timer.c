@@ -3,10 +3,15 @@
 #include <inttypes.h>
 #include <round.h>
 #include <stdio.h>
+#include <vtime.h>
 #include "devices/pit.h"
 #include "threads/interrupt.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
+#include "threads/vaddr.h"
+#ifdef USERPROG
+#include "userprog/poll.h"
+#endif
   
 /* See [8254] for hardware details of the 8254 timer chip. */
 
@@ -39,6 +44,17 @@ timer_init (void)
   intr_register_ext (0x20, timer_interrupt, "8254 Timer");
 }
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 프로세스에 읽기 전용으로 매핑되는 시간 페이지 (lib/vtime.h)
+// 타이머 인터럽트마다 갱신, 한 페이지 전체를 차지해야 매핑할 수 있음
+static union
+  {
+    struct vtime vtime;
+    uint8_t page[PGSIZE];
+  }
+vtime_page __attribute__ ((aligned (PGSIZE)));
+
+static void vtime_update (void);
+
 /* Calibrates loops_per_tick, used to implement brief delays. */
 void
 timer_calibrate (void) 
@@ -66,6 +82,36 @@ timer_calibrate (void)
   printf ("%'"PRIu64" loops/s.\n", (uint64_t) loops_per_tick * TIMER_FREQ);
 }
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 시간 페이지의 커널 주소 (process.c가 유저 프로세스에 매핑)
+void *
+timer_vtime_page (void)
+{
+  return &vtime_page;
+}
+
+// 타이머 인터럽트에서 호출, seq를 홀수로 만들고 갱신한 뒤 다시 짝수로
+// tsc_per_tick은 최근 tick 간격의 이동 평균 (1/8씩 반영)
+static void
+vtime_update (void)
+{
+  struct vtime *v = &vtime_page.vtime;
+  uint64_t now = timer_rdtsc ();
+
+  v->seq++;
+  barrier ();
+  if (v->tsc != 0)
+    {
+      uint64_t delta = now - v->tsc;
+      v->tsc_per_tick = (v->tsc_per_tick == 0 ? delta
+                         : (v->tsc_per_tick * 7 + delta) / 8);
+    }
+  v->freq = TIMER_FREQ;
+  v->ticks = ticks;
+  v->tsc = now;
+  barrier ();
+  v->seq++;
+}
+
 /* Returns the number of timer ticks since the OS booted. */
 int64_t
 timer_ticks (void) 
@@ -172,12 +218,17 @@ timer_print_stats (void)
 
 /* Timer interrupt handler. */
 static void
-timer_interrupt (struct intr_frame *args UNUSED)
+timer_interrupt (struct intr_frame *args)
 {
   ticks++;
-  thread_tick ();
+  vtime_update ();
+  thread_tick (args);
   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - sleep_list를 돌면서 wake up 할 시간에 깨워줌
   thread_wake_up(ticks);
+#ifdef USERPROG
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - poll() timeout
+  poll_tick(ticks);
+#endif
 }
 
 /* Returns true if LOOPS iterations waits for more than one timer
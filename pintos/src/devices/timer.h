@@ -26,4 +26,16 @@ void timer_ndelay (int64_t nanoseconds);
 
 void timer_print_stats (void);
 
+void *timer_vtime_page (void);
+
+/* Returns the CPU's time-stamp counter, which counts clock cycles
+   since reset.  Useful for timing intervals shorter than a tick. */
+static inline uint64_t
+timer_rdtsc (void)
+{
+  uint64_t tsc;
+  asm volatile ("rdtsc" : "=A" (tsc));
+  return tsc;
+}
+
 #endif /* devices/timer.h */
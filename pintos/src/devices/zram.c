@@ -0,0 +1,620 @@
+#include "devices/zram.h"
+#include <debug.h>
+#include <round.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/block.h"
+#include "threads/loader.h"
+#include "threads/malloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 원래 스왑 장치 대신 BLOCK_SWAP 역할을 맡는 "zram0"
+// 스왑은 한 페이지 (슬롯, 섹터 SECTORS_PER_SLOT개)씩 쓰니까 섹터를 buf에 모았다가 한 페이지를 통째로 압축
+// 압축한 내용은 CHUNK_SIZE 조각으로 나눠서 malloc()에 둠 (1 kB 넘게 malloc()하면 한 페이지를 다 씀)
+// 예산을 다 썼거나 잘 안 줄어드는 페이지는 원래 스왑 디스크의 같은 자리에 씀
+// 디스크가 없으면 장치 크기는 예산 x ZRAM_RATIO (압축이 잘 된다고 보고), 조각은 쓸 때 malloc()
+// -> swap_alloc()이 block_reserve()로 슬롯마다 최악 (압축 안 한 한 페이지)만큼 조각을 예약
+//    예산이나 메모리가 모자라면 swap_alloc()이 실패하고, 예약한 슬롯의 저장은 실패할 일이 없음
+// 디스크에 넘긴 섹터는 zram0을 읽고 쓸 때 이미 셈 -> 디스크 쪽은 rusage에 다시 세지 않음
+// 코덱은 LZ4 블록 형식을 흉내 낸 LZ77: 토큰 (리터럴 길이 4비트 | 매치 길이 4비트), 리터럴, 2바이트 거리
+
+/* Sectors per page-sized swap slot. */
+#define SECTORS_PER_SLOT (PGSIZE / BLOCK_SECTOR_SIZE)
+#define ALL_SECTORS ((1u << SECTORS_PER_SLOT) - 1)
+
+/* Pages that do not compress to this many bytes or fewer go to
+   disk (or are kept uncompressed, without a disk). */
+#define MAX_CSIZE (PGSIZE * 3 / 4)
+
+/* Without a disk, the device holds this many pages per page of
+   budget.  Swapped-out pages typically compress 2 to 3 times. */
+#define ZRAM_RATIO 3
+
+/* A piece of a compressed page.  CHUNK_SIZE is one of malloc()'s
+   block sizes, so a chunk wastes nothing beyond the next
+   pointer. */
+#define CHUNK_SIZE 256
+#define CHUNK_DATA (CHUNK_SIZE - sizeof (struct chunk *))
+#define PAGE_CHUNKS DIV_ROUND_UP (PGSIZE, CHUNK_DATA)
+struct chunk
+  {
+    struct chunk *next;
+    uint8_t data[CHUNK_DATA];
+  };
+
+/* Where a slot's contents are. */
+enum slot_state
+  {
+    SLOT_EMPTY,                 /* Never written or discarded: zeros. */
+    SLOT_MEM,                   /* In CHUNKS. */
+    SLOT_DISK                   /* On the backing disk. */
+  };
+
+/* A page-sized slot. */
+struct slot
+  {
+    struct chunk *chunks;       /* 내용, SLOT_MEM일 때만. */
+    uint16_t size;              /* 압축한 크기, PGSIZE면 압축 안 함. */
+    uint8_t state;              /* enum slot_state. */
+    bool reserved;              /* 예약만 하고 아직 안 씀 (디스크 없을 때). */
+  };
+
+static struct block *disk;      /* 넘칠 때 쓰는 원래 스왑 장치, 없으면 NULL. */
+static struct slot *slots;
+static size_t slot_cnt;
+static size_t budget;           /* chunks에 쓸 수 있는 바이트. */
+static size_t used;             /* chunks에 쓰고 있는 바이트. */
+static size_t reserved_chunks;  /* 예약한 슬롯들이 최악일 때 쓸 조각 수. */
+static struct chunk *free_chunks; /* 예약한 만큼 받아 둔 조각들. */
+static size_t free_cnt;         /* free_chunks의 조각 수, reserved_chunks 이상. */
+static struct lock zram_lock;   /* 아래 버퍼들과 slots. */
+
+/* Slot being read or written a sector at a time. */
+static uint8_t buf[PGSIZE];
+static size_t buf_slot = SIZE_MAX; /* buf의 슬롯, 없으면 SIZE_MAX. */
+static unsigned buf_valid;      /* buf에서 유효한 섹터 (비트마스크). */
+static bool buf_dirty;          /* 아직 저장 안 한 섹터가 있나. */
+
+static uint8_t cbuf[PGSIZE];    /* 압축한 내용. */
+static uint8_t tmp[PGSIZE];     /* 저장된 슬롯을 풀어 놓는 곳. */
+
+static struct block_operations zram_operations;
+
+static void fill (size_t slot);
+static void flush (void);
+static void load (size_t slot, void *page);
+static void store (size_t slot, const void *page);
+static bool store_mem (struct slot *, const void *, size_t size);
+static void release (size_t slot);
+static bool reserve (size_t slot, size_t end);
+static void unreserve (size_t slot);
+static size_t chunk_bytes (size_t size);
+static struct chunk *chunk_alloc (void);
+static void chunk_free (struct chunk *);
+static void trim_chunks (void);
+
+static size_t lz_compress (const uint8_t *src, size_t n,
+                           uint8_t *dst, size_t cap);
+static size_t lz_decompress (const uint8_t *src, size_t n,
+                             uint8_t *dst, size_t cap);
+
+/* Puts a compressed in-memory swap device in front of the
+   current swap device, if any, with room for BUDGET_KB kB of
+   compressed pages, or an eighth of RAM for ZRAM_DEFAULT.
+   Without a swap device the device holds ZRAM_RATIO times the
+   budget, and swap_alloc() fails once the budget cannot cover
+   the worst case of the slots it asks for.  Memory is only
+   taken as pages are stored.  Does nothing if BUDGET_KB is 0.
+   Must be called after the swap device is located and before
+   swap_init(). */
+void
+zram_init (size_t budget_kb)
+{
+  char info[64];
+
+  budget = (budget_kb == ZRAM_DEFAULT
+            ? init_ram_pages * PGSIZE / 8 : budget_kb * 1024);
+  if (budget == 0)
+    return;
+
+  disk = block_get_role (BLOCK_SWAP);
+  slot_cnt = (disk != NULL
+              ? block_size (disk) / SECTORS_PER_SLOT
+              : budget / PGSIZE * ZRAM_RATIO);
+  slots = slot_cnt != 0 ? calloc (slot_cnt, sizeof *slots) : NULL;
+  if (slots == NULL)
+    {
+      if (slot_cnt != 0)
+        printf ("zram: out of memory, not used\n");
+      return;
+    }
+  lock_init (&zram_lock);
+
+  snprintf (info, sizeof info, "compressed swap, %zu kB in memory%s%s",
+            budget / 1024, disk != NULL ? " over " : "",
+            disk != NULL ? block_name (disk) : "");
+  block_set_role (BLOCK_SWAP,
+                  block_register ("zram0", BLOCK_SWAP, info,
+                                  slot_cnt * SECTORS_PER_SLOT,
+                                  &zram_operations, NULL));
+}
+
+static void
+zram_read (void *aux UNUSED, block_sector_t sector, void *buffer)
+{
+  size_t slot = sector / SECTORS_PER_SLOT;
+  size_t i = sector % SECTORS_PER_SLOT;
+
+  lock_acquire (&zram_lock);
+  if (buf_slot != slot || !(buf_valid & (1u << i)))
+    fill (slot);
+  memcpy (buffer, buf + i * BLOCK_SECTOR_SIZE, BLOCK_SECTOR_SIZE);
+  lock_release (&zram_lock);
+}
+
+static void
+zram_write (void *aux UNUSED, block_sector_t sector, const void *buffer)
+{
+  size_t slot = sector / SECTORS_PER_SLOT;
+  size_t i = sector % SECTORS_PER_SLOT;
+
+  lock_acquire (&zram_lock);
+  if (buf_slot != slot)
+    {
+      flush ();
+      buf_slot = slot;
+      buf_valid = 0;
+    }
+  memcpy (buf + i * BLOCK_SECTOR_SIZE, buffer, BLOCK_SECTOR_SIZE);
+  buf_valid |= 1u << i;
+  buf_dirty = true;
+
+  // 한 페이지를 다 받았으면 바로 압축
+  if (buf_valid == ALL_SECTORS)
+    flush ();
+  lock_release (&zram_lock);
+}
+
+// 슬롯 전체를 버림 (swap_free()), 걸친 슬롯은 그대로
+static void
+zram_discard (void *aux UNUSED, block_sector_t sector, block_sector_t cnt)
+{
+  size_t slot = DIV_ROUND_UP (sector, SECTORS_PER_SLOT);
+  size_t end = (sector + cnt) / SECTORS_PER_SLOT;
+
+  lock_acquire (&zram_lock);
+  for (; slot < end; slot++)
+    {
+      if (buf_slot == slot)
+        {
+          buf_slot = SIZE_MAX;
+          buf_dirty = false;
+        }
+      release (slot);
+      unreserve (slot);
+    }
+  lock_release (&zram_lock);
+}
+
+// 디스크가 있으면 못 넣는 페이지는 디스크로 가니까 예약할 게 없음
+static bool
+zram_reserve (void *aux UNUSED, block_sector_t sector, block_sector_t cnt)
+{
+  bool ok;
+
+  if (disk != NULL)
+    return true;
+  lock_acquire (&zram_lock);
+  ok = reserve (sector / SECTORS_PER_SLOT,
+                DIV_ROUND_UP (sector + cnt, SECTORS_PER_SLOT));
+  lock_release (&zram_lock);
+  return ok;
+}
+
+static struct block_operations zram_operations =
+  {
+    zram_read,
+    zram_write,
+    zram_discard,
+    zram_reserve
+  };
+
+// buf를 SLOT의 내용으로 채움, buf에 먼저 써 둔 섹터는 그대로 둠
+static void
+fill (size_t slot)
+{
+  size_t i;
+
+  if (buf_slot != slot)
+    {
+      flush ();
+      buf_slot = slot;
+      buf_valid = 0;
+    }
+  load (slot, tmp);
+  for (i = 0; i < SECTORS_PER_SLOT; i++)
+    if (!(buf_valid & (1u << i)))
+      memcpy (buf + i * BLOCK_SECTOR_SIZE, tmp + i * BLOCK_SECTOR_SIZE,
+              BLOCK_SECTOR_SIZE);
+  buf_valid = ALL_SECTORS;
+}
+
+// buf에 쓴 내용을 저장, 저장한 뒤에도 buf는 읽기 캐시로 남음
+static void
+flush (void)
+{
+  if (!buf_dirty)
+    return;
+  if (buf_valid != ALL_SECTORS)
+    fill (buf_slot);
+  store (buf_slot, buf);
+  buf_dirty = false;
+}
+
+/* Reads the stored contents of SLOT into PAGE. */
+static void
+load (size_t slot, void *page)
+{
+  struct slot *s = &slots[slot];
+  size_t i;
+
+  if (s->state == SLOT_EMPTY)
+    memset (page, 0, PGSIZE);
+  else if (s->state == SLOT_DISK)
+    for (i = 0; i < SECTORS_PER_SLOT; i++)
+      block_read_uncharged (disk, slot * SECTORS_PER_SLOT + i,
+                            (uint8_t *) page + i * BLOCK_SECTOR_SIZE);
+  else
+    {
+      uint8_t *dst = s->size == PGSIZE ? page : cbuf;
+      struct chunk *c;
+      size_t ofs;
+
+      for (c = s->chunks, ofs = 0; ofs < s->size; c = c->next)
+        {
+          size_t n = s->size - ofs < CHUNK_DATA ? s->size - ofs : CHUNK_DATA;
+          memcpy (dst + ofs, c->data, n);
+          ofs += n;
+        }
+      if (s->size != PGSIZE && lz_decompress (cbuf, s->size, page, PGSIZE)
+                               != PGSIZE)
+        PANIC ("zram: slot %zu is corrupt", slot);
+    }
+}
+
+/* Stores PAGE as the contents of SLOT: compressed in memory if
+   it compresses well and the budget allows, otherwise on the
+   backing disk. */
+static void
+store (size_t slot, const void *page)
+{
+  struct slot *s = &slots[slot];
+  size_t size;
+  size_t i;
+
+  release (slot);
+  size = lz_compress (page, PGSIZE, cbuf, MAX_CSIZE);
+  if (disk == NULL)
+    {
+      // 예약해 둔 조각으로 충분 (swap_alloc()을 거치지 않은 쓰기면 지금 예약)
+      bool ok;
+
+      if (!s->reserved && !reserve (slot, slot + 1))
+        PANIC ("zram: no room for slot %zu, not reserved", slot);
+      ok = (size != 0 ? store_mem (s, cbuf, size)
+                      : store_mem (s, page, PGSIZE));
+      ASSERT (ok);
+      unreserve (slot);
+      return;
+    }
+  if (size != 0 && used + chunk_bytes (size) <= budget
+      && store_mem (s, cbuf, size))
+    return;
+
+  for (i = 0; i < SECTORS_PER_SLOT; i++)
+    block_write_uncharged (disk, slot * SECTORS_PER_SLOT + i,
+                           (const uint8_t *) page + i * BLOCK_SECTOR_SIZE);
+  s->state = SLOT_DISK;
+}
+
+/* Copies SIZE bytes of DATA into newly allocated chunks for S.
+   Returns false if memory runs out. */
+static bool
+store_mem (struct slot *s, const void *data, size_t size)
+{
+  struct chunk **tail = &s->chunks;
+  size_t ofs;
+
+  s->chunks = NULL;
+  for (ofs = 0; ofs < size; ofs += CHUNK_DATA)
+    {
+      size_t n = size - ofs < CHUNK_DATA ? size - ofs : CHUNK_DATA;
+      struct chunk *c = chunk_alloc ();
+      if (c == NULL)
+        {
+          while (s->chunks != NULL)
+            {
+              c = s->chunks;
+              s->chunks = c->next;
+              chunk_free (c);
+            }
+          return false;
+        }
+      memcpy (c->data, (const uint8_t *) data + ofs, n);
+      c->next = NULL;
+      *tail = c;
+      tail = &c->next;
+    }
+  s->size = size;
+  s->state = SLOT_MEM;
+  used += chunk_bytes (size);
+  return true;
+}
+
+/* Frees whatever SLOT holds in memory and marks it empty. */
+static void
+release (size_t slot)
+{
+  struct slot *s = &slots[slot];
+
+  if (s->state == SLOT_MEM)
+    {
+      while (s->chunks != NULL)
+        {
+          struct chunk *c = s->chunks;
+          s->chunks = c->next;
+          chunk_free (c);
+        }
+      used -= chunk_bytes (s->size);
+    }
+  s->state = SLOT_EMPTY;
+}
+
+/* Reserves the budget and the chunks to store an uncompressed
+   page in each of the slots from SLOT up to END, for use without
+   a backing disk.  Returns false, reserving nothing, if the
+   budget or memory runs out. */
+static bool
+reserve (size_t slot, size_t end)
+{
+  size_t need = 0;
+  size_t i;
+
+  for (i = slot; i < end; i++)
+    if (!slots[i].reserved)
+      need += PAGE_CHUNKS;
+  if (used + (reserved_chunks + need) * CHUNK_SIZE > budget)
+    return false;
+  reserved_chunks += need;
+  while (free_cnt < reserved_chunks)
+    {
+      struct chunk *c = malloc (sizeof *c);
+      if (c == NULL)
+        {
+          reserved_chunks -= need;
+          trim_chunks ();
+          return false;
+        }
+      chunk_free (c);
+    }
+  for (; slot < end; slot++)
+    slots[slot].reserved = true;
+  return true;
+}
+
+/* Gives back SLOT's reservation, if it has one. */
+static void
+unreserve (size_t slot)
+{
+  struct slot *s = &slots[slot];
+
+  if (s->reserved)
+    {
+      s->reserved = false;
+      reserved_chunks -= PAGE_CHUNKS;
+      trim_chunks ();
+    }
+}
+
+/* Returns the memory taken by SIZE bytes stored in chunks. */
+static size_t
+chunk_bytes (size_t size)
+{
+  return DIV_ROUND_UP (size, CHUNK_DATA) * CHUNK_SIZE;
+}
+
+/* Returns a chunk from free_chunks, where reservations keep
+   them, or else from malloc().  Returns a null pointer if none
+   is available. */
+static struct chunk *
+chunk_alloc (void)
+{
+  struct chunk *c = free_chunks;
+
+  if (c == NULL)
+    return malloc (sizeof *c);
+  free_chunks = c->next;
+  free_cnt--;
+  return c;
+}
+
+/* Keeps chunk C in free_chunks if reservations still need it,
+   otherwise frees it. */
+static void
+chunk_free (struct chunk *c)
+{
+  if (free_cnt >= reserved_chunks)
+    free (c);
+  else
+    {
+      c->next = free_chunks;
+      free_chunks = c;
+      free_cnt++;
+    }
+}
+
+/* Frees the chunks in free_chunks beyond what reservations
+   need. */
+static void
+trim_chunks (void)
+{
+  while (free_cnt > reserved_chunks)
+    free (chunk_alloc ());
+}
+
+/* LZ codec. */
+
+#define LZ_MIN_MATCH 4          /* 이것보다 짧은 매치는 리터럴로. */
+#define LZ_HASH_BITS 12
+
+/* Most recent position of each hashed 4-byte sequence.  Never
+   cleared: a stale position is only a guess that the byte
+   comparison rejects. */
+static uint16_t lz_table[1 << LZ_HASH_BITS];
+
+static uint32_t
+lz_read32 (const uint8_t *p)
+{
+  uint32_t v;
+  memcpy (&v, p, sizeof v);
+  return v;
+}
+
+static uint8_t *
+lz_put_len (uint8_t *op, size_t len)
+{
+  for (; len >= 255; len -= 255)
+    *op++ = 255;
+  *op++ = len;
+  return op;
+}
+
+/* Appends a sequence of LIT_LEN literal bytes from LIT followed by
+   a MATCH_LEN-byte match OFFSET bytes back (no match if MATCH_LEN
+   is 0) at OP.  Returns the new end of output, or a null pointer
+   if it would pass OEND. */
+static uint8_t *
+lz_emit (uint8_t *op, const uint8_t *oend, const uint8_t *lit,
+         size_t lit_len, size_t offset, size_t match_len)
+{
+  size_t ml = match_len != 0 ? match_len - LZ_MIN_MATCH : 0;
+  size_t need = 1 + lit_len / 255 + 1 + lit_len
+                + (match_len != 0 ? 2 + ml / 255 + 1 : 0);
+
+  if (need > (size_t) (oend - op))
+    return NULL;
+  *op++ = (lit_len < 15 ? lit_len : 15) << 4 | (ml < 15 ? ml : 15);
+  if (lit_len >= 15)
+    op = lz_put_len (op, lit_len - 15);
+  memcpy (op, lit, lit_len);
+  op += lit_len;
+  if (match_len != 0)
+    {
+      *op++ = offset & 0xff;
+      *op++ = offset >> 8;
+      if (ml >= 15)
+        op = lz_put_len (op, ml - 15);
+    }
+  return op;
+}
+
+/* Compresses the N bytes at SRC (at most 64 kB) into DST.
+   Returns the compressed size, or 0 if it would exceed CAP
+   bytes. */
+static size_t
+lz_compress (const uint8_t *src, size_t n, uint8_t *dst, size_t cap)
+{
+  const uint8_t *ip = src, *anchor = src, *end = src + n;
+  uint8_t *op = dst;
+
+  ASSERT (n <= 65536);
+  while (end - ip >= LZ_MIN_MATCH)
+    {
+      uint32_t seq = lz_read32 (ip);
+      size_t h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+      const uint8_t *ref = src + lz_table[h];
+      const uint8_t *m, *r;
+
+      lz_table[h] = ip - src;
+      if (ref >= ip || lz_read32 (ref) != seq)
+        {
+          ip++;
+          continue;
+        }
+
+      for (m = ip + LZ_MIN_MATCH, r = ref + LZ_MIN_MATCH; m < end && *m == *r;
+           m++, r++)
+        continue;
+      op = lz_emit (op, dst + cap, anchor, ip - anchor, ip - ref, m - ip);
+      if (op == NULL)
+        return 0;
+      ip = anchor = m;
+    }
+
+  op = lz_emit (op, dst + cap, anchor, end - anchor, 0, 0);
+  return op != NULL ? (size_t) (op - dst) : 0;
+}
+
+/* Adds an extended length at *IP to *LEN.  Returns false if the
+   input ends first. */
+static bool
+lz_get_len (const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+  uint8_t b;
+
+  do
+    {
+      if (*ip >= iend)
+        return false;
+      b = *(*ip)++;
+      *len += b;
+    }
+  while (b == 255);
+  return true;
+}
+
+/* Decompresses the N bytes at SRC into DST, which has room for
+   CAP bytes.  Returns the decompressed size, or 0 if the input
+   is malformed. */
+static size_t
+lz_decompress (const uint8_t *src, size_t n, uint8_t *dst, size_t cap)
+{
+  const uint8_t *ip = src, *iend = src + n;
+  uint8_t *op = dst, *oend = dst + cap;
+
+  while (ip < iend)
+    {
+      uint8_t token = *ip++;
+      size_t len, offset;
+
+      len = token >> 4;
+      if (len == 15 && !lz_get_len (&ip, iend, &len))
+        return 0;
+      if (len > (size_t) (iend - ip) || len > (size_t) (oend - op))
+        return 0;
+      memcpy (op, ip, len);
+      op += len;
+      ip += len;
+      if (ip == iend)
+        break;
+
+      // 매치, 겹칠 수 있어서 한 바이트씩 복사
+      if (iend - ip < 2)
+        return 0;
+      offset = ip[0] | ip[1] << 8;
+      ip += 2;
+      len = token & 15;
+      if (len == 15 && !lz_get_len (&ip, iend, &len))
+        return 0;
+      len += LZ_MIN_MATCH;
+      if (offset == 0 || offset > (size_t) (op - dst)
+          || len > (size_t) (oend - op))
+        return 0;
+      for (; len > 0; len--, op++)
+        *op = op[-offset];
+    }
+  return op - dst;
+}
@@ -0,0 +1,13 @@
+#ifndef DEVICES_ZRAM_H
+#define DEVICES_ZRAM_H
+
+#include <stddef.h>
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 스왑 페이지를 압축해서 커널 메모리에 두는 블록 장치
+
+/* Memory budget that zram_init() picks for itself. */
+#define ZRAM_DEFAULT ((size_t) -1)
+
+void zram_init (size_t budget_kb);
+
+#endif /* devices/zram.h */
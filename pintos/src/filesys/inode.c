@@ -49,6 +49,7 @@ struct inode
     int open_cnt;                       /* Number of openers. */
     bool removed;                       /* True if deleted, false otherwise. */
     int deny_write_cnt;                 /* 0: writes ok, >0: deny writes. */
+    unsigned write_gen;                 /* Incremented by each write. */
     struct inode_disk data;             /* Inode content. */
   };
 
@@ -205,6 +206,7 @@ inode_open (block_sector_t sector)
   inode->sector = sector;
   inode->open_cnt = 1;
   inode->deny_write_cnt = 0;
+  inode->write_gen = 0;
   inode->removed = false;
   block_read (fs_device, inode->sector, &inode->data);
   return inode;
@@ -415,6 +417,7 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 
   if (inode->deny_write_cnt)
     return 0;
+  inode->write_gen++;
 
   //! grow 해야한다면
   off_t end = offset + size;  // 쓰려는 마지막 바이트 위치
@@ -474,6 +477,15 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
   return bytes_written;
 }
 
+/* Returns a number that changes whenever INODE is written.
+   Lets caches of file contents notice that they are stale, for
+   as long as they keep INODE open. */
+unsigned
+inode_write_gen (const struct inode *inode)
+{
+  return inode->write_gen;
+}
+
 /* Disables writes to INODE.
    May be called at most once per inode opener. */
 void
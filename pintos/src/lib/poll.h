@@ -0,0 +1,20 @@
+#ifndef __LIB_POLL_H
+#define __LIB_POLL_H
+
+/* Events for poll().  Shared by the kernel and user programs. */
+#define POLLIN 0x001            /* Data can be read without blocking. */
+#define POLLOUT 0x004           /* Data can be written without blocking. */
+#define POLLERR 0x008           /* Pipe write end with no readers left. */
+#define POLLHUP 0x010           /* Pipe read end with no writers left. */
+#define POLLNVAL 0x020          /* FD is not open. */
+
+/* One file descriptor to poll().  POLLERR, POLLHUP and POLLNVAL
+   are reported in REVENTS even if not requested in EVENTS. */
+struct pollfd
+  {
+    int fd;                     /* File descriptor, ignored if negative. */
+    short events;               /* Requested events. */
+    short revents;              /* Returned events. */
+  };
+
+#endif /* lib/poll.h */
@@ -0,0 +1,25 @@
+#ifndef __LIB_RUSAGE_H
+#define __LIB_RUSAGE_H
+
+#include <stdint.h>
+
+/* Values for getrusage()'s WHO argument. */
+#define RUSAGE_SELF 0           /* The calling process. */
+#define RUSAGE_CHILDREN 1       /* Children that have been waited for. */
+
+/* Resource usage of a process.
+   Shared by the kernel and user programs. */
+struct rusage
+  {
+    int64_t user_ticks;         /* Timer ticks spent in user mode. */
+    int64_t kernel_ticks;       /* Timer ticks spent in the kernel. */
+    uint32_t nvcsw;             /* Voluntary context switches. */
+    uint32_t nivcsw;            /* Involuntary context switches. */
+    uint32_t page_faults;       /* Page faults taken. */
+    uint32_t sectors_read;      /* Disk sectors read. */
+    uint32_t sectors_written;   /* Disk sectors written. */
+    uint64_t bytes_read;        /* Bytes transferred by read(). */
+    uint64_t bytes_written;     /* Bytes transferred by write(). */
+  };
+
+#endif /* lib/rusage.h */
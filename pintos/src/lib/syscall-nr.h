@@ -28,7 +28,26 @@ enum
     SYS_MKDIR,                  /* Create a directory. */
     SYS_READDIR,                /* Reads a directory entry. */
     SYS_ISDIR,                  /* Tests if a fd represents a directory. */
-    SYS_INUMBER                 /* Returns the inode number for a fd. */
+    SYS_INUMBER,                /* Returns the inode number for a fd. */
+
+    /* Extensions. */
+    SYS_GETRUSAGE,              /* Obtain resource usage statistics. */
+    SYS_SPAWN,                  /* Start another process without waiting. */
+    SYS_WAITPID,                /* Wait for any or a given child, optionally
+                                   without blocking. */
+    SYS_PIPE,                   /* Create an anonymous pipe. */
+    SYS_SHM_CREATE,             /* Create a shared memory segment. */
+    SYS_SHM_ATTACH,             /* Map a shared memory segment. */
+    SYS_SHM_DETACH,             /* Unmap a shared memory segment. */
+    SYS_URING_SETUP,            /* Map a batched system call ring. */
+    SYS_URING_ENTER,            /* Run the requests queued in the ring. */
+    SYS_POLL,                   /* Wait for one of several fds. */
+    SYS_FUTEX,                  /* Wait on or wake a user-space lock. */
+    SYS_THREAD_CREATE,          /* Start another thread in this process. */
+    SYS_THREAD_JOIN,            /* Wait for a thread to exit. */
+    SYS_THREAD_EXIT,            /* Terminate the calling thread. */
+    SYS_MSLEEP,                 /* Sleep for some milliseconds. */
+    SYS_FORK                    /* Clone the current process. */
   };
 
 #endif /* lib/syscall-nr.h */
@@ -0,0 +1,48 @@
+#ifndef __LIB_URING_H
+#define __LIB_URING_H
+
+#include <stdint.h>
+
+/* Batched system call ring, mapped into a user process by
+   uring_setup().  Shared by the kernel and user programs.
+
+   The process queues requests in SQ at SQ_TAIL and calls
+   uring_enter(), which runs them in order, advancing SQ_HEAD,
+   and posts one completion per request in CQ at CQ_TAIL.  The
+   process consumes completions by advancing CQ_HEAD.  Indexes
+   run freely and are reduced modulo the ring size. */
+
+#define URING_SQ_ENTRIES 128    /* Submission ring size (power of 2). */
+#define URING_CQ_ENTRIES 128    /* Completion ring size (power of 2). */
+
+/* A queued system call.  OP is a SYS_* number; only SYS_READ,
+   SYS_WRITE, SYS_SEEK, SYS_OPEN and SYS_CLOSE are accepted.
+   ARGS are the same arguments the system call takes on the
+   stack. */
+struct uring_sqe
+  {
+    int32_t op;                 /* System call number. */
+    uint32_t args[3];           /* System call arguments. */
+    uint32_t user_data;         /* Copied to the completion. */
+  };
+
+/* Completion of one request. */
+struct uring_cqe
+  {
+    uint32_t user_data;         /* From the request. */
+    int32_t res;                /* System call return value,
+                                   or -1 for a rejected OP. */
+  };
+
+/* Layout of the shared page. */
+struct uring
+  {
+    uint32_t sq_head;           /* Advanced by the kernel. */
+    uint32_t sq_tail;           /* Advanced by the process. */
+    uint32_t cq_head;           /* Advanced by the process. */
+    uint32_t cq_tail;           /* Advanced by the kernel. */
+    struct uring_sqe sq[URING_SQ_ENTRIES];
+    struct uring_cqe cq[URING_CQ_ENTRIES];
+  };
+
+#endif /* lib/uring.h */
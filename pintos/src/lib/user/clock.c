@@ -0,0 +1,57 @@
+#include <clock.h>
+#include <vtime.h>
+
+/* Copies a consistent snapshot of the time page into *V. */
+static void
+read_vtime (struct vtime *v) 
+{
+  const volatile struct vtime *page = VTIME_ADDR;
+  uint32_t seq;
+
+  do
+    {
+      seq = page->seq;
+      v->freq = page->freq;
+      v->ticks = page->ticks;
+      v->tsc = page->tsc;
+      v->tsc_per_tick = page->tsc_per_tick;
+    }
+  while ((seq & 1) != 0 || seq != page->seq);
+}
+
+/* Returns the number of timer ticks since boot. */
+int64_t
+clock_ticks (void) 
+{
+  struct vtime v;
+  read_vtime (&v);
+  return v.ticks;
+}
+
+/* Returns the number of nanoseconds since boot.  Between ticks,
+   interpolates with the CPU's time-stamp counter. */
+uint64_t
+clock_ns (void) 
+{
+  struct vtime v;
+  uint64_t ns_per_tick, ns, tsc;
+
+  read_vtime (&v);
+  if (v.freq == 0)
+    return 0;
+  ns_per_tick = 1000000000 / v.freq;
+  ns = v.ticks * ns_per_tick;
+
+  if (v.tsc_per_tick != 0)
+    {
+      uint64_t frac;
+
+      asm volatile ("rdtsc" : "=A" (tsc));
+      frac = (tsc - v.tsc) * ns_per_tick / v.tsc_per_tick;
+
+      /* Never reach the next tick's time, so that the clock does
+         not run backward when the next tick is recorded. */
+      ns += frac < ns_per_tick ? frac : ns_per_tick - 1;
+    }
+  return ns;
+}
@@ -0,0 +1,69 @@
+#include <mutex.h>
+#include <syscall.h>
+
+/* Atomically sets *P to NEW if it equals OLD.
+   Returns the previous value of *P. */
+static inline int
+cmpxchg (int *p, int old, int new)
+{
+  int prev;
+  asm volatile ("lock cmpxchgl %2, %1"
+                : "=a" (prev), "+m" (*p)
+                : "r" (new), "0" (old)
+                : "memory");
+  return prev;
+}
+
+/* Atomically sets *P to NEW and returns its previous value. */
+static inline int
+xchg (int *p, int new)
+{
+  asm volatile ("xchgl %0, %1"
+                : "+r" (new), "+m" (*p)
+                :
+                : "memory");
+  return new;
+}
+
+/* Initializes M as unlocked. */
+void
+mutex_init (struct mutex *m) 
+{
+  m->state = 0;
+}
+
+/* Acquires M, sleeping in the kernel until it is available. */
+void
+mutex_lock (struct mutex *m) 
+{
+  int c = cmpxchg (&m->state, 0, 1);
+  if (c == 0)
+    return;
+
+  /* Contended: mark that there may be sleepers, then sleep
+     until an unlock finds the mutex free for us. */
+  if (c != 2)
+    c = xchg (&m->state, 2);
+  while (c != 0)
+    {
+      futex (&m->state, FUTEX_WAIT, 2);
+      c = xchg (&m->state, 2);
+    }
+}
+
+/* Tries to acquire M without sleeping.
+   Returns true if successful, false if M is held. */
+bool
+mutex_trylock (struct mutex *m) 
+{
+  return cmpxchg (&m->state, 0, 1) == 0;
+}
+
+/* Releases M, which must be held by the caller, and wakes one
+   sleeper if there may be any. */
+void
+mutex_unlock (struct mutex *m) 
+{
+  if (xchg (&m->state, 0) == 2)
+    futex (&m->state, FUTEX_WAKE, 1);
+}
@@ -0,0 +1,29 @@
+#ifndef __LIB_USER_MUTEX_H
+#define __LIB_USER_MUTEX_H
+
+#include <stdbool.h>
+
+/* A mutex for user programs, built on futex().
+
+   Locking and unlocking an uncontended mutex is a single atomic
+   instruction with no system call.  Only a thread that finds
+   the mutex held enters the kernel to sleep, and only an unlock
+   that may have sleepers enters the kernel to wake one.
+
+   The mutex may live in memory shared by several processes, for
+   example a segment from shm_create(). */
+struct mutex
+  {
+    int state;          /* 0: unlocked.
+                           1: locked, no sleepers.
+                           2: locked, maybe sleepers. */
+  };
+
+#define MUTEX_INITIALIZER { 0 }
+
+void mutex_init (struct mutex *);
+void mutex_lock (struct mutex *);
+bool mutex_trylock (struct mutex *);
+void mutex_unlock (struct mutex *);
+
+#endif /* lib/user/mutex.h */
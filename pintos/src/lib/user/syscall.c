@@ -182,3 +182,109 @@ inumber (int fd)
 {
   return syscall1 (SYS_INUMBER, fd);
 }
+
+int
+getrusage (int who, struct rusage *usage)
+{
+  return syscall2 (SYS_GETRUSAGE, who, usage);
+}
+
+pid_t
+spawn (const char *file)
+{
+  return (pid_t) syscall1 (SYS_SPAWN, file);
+}
+
+pid_t
+waitpid (pid_t pid, int *status, int options)
+{
+  return (pid_t) syscall3 (SYS_WAITPID, pid, status, options);
+}
+
+int
+pipe (int fds[2])
+{
+  return syscall1 (SYS_PIPE, fds);
+}
+
+int
+shm_create (size_t size)
+{
+  return syscall1 (SYS_SHM_CREATE, size);
+}
+
+void *
+shm_attach (int id, void *addr)
+{
+  return (void *) syscall2 (SYS_SHM_ATTACH, id, addr);
+}
+
+bool
+shm_detach (void *addr)
+{
+  return syscall1 (SYS_SHM_DETACH, addr);
+}
+
+struct uring *
+uring_setup (void *addr)
+{
+  return (struct uring *) syscall1 (SYS_URING_SETUP, addr);
+}
+
+int
+uring_enter (unsigned to_submit)
+{
+  return syscall1 (SYS_URING_ENTER, to_submit);
+}
+
+int
+poll (struct pollfd *fds, unsigned nfds, int timeout)
+{
+  return syscall3 (SYS_POLL, fds, nfds, timeout);
+}
+
+int
+futex (int *addr, int op, int val)
+{
+  return syscall3 (SYS_FUTEX, addr, op, val);
+}
+
+/* First function run by a thread made by thread_create().
+   Calls FN(ARG), then ends the thread. */
+static void
+thread_start (void (*fn) (void *), void *arg)
+{
+  fn (arg);
+  thread_exit ();
+}
+
+tid_t
+thread_create (void (*fn) (void *), void *arg)
+{
+  return (tid_t) syscall3 (SYS_THREAD_CREATE, thread_start, fn, arg);
+}
+
+int
+thread_join (tid_t tid)
+{
+  return syscall1 (SYS_THREAD_JOIN, tid);
+}
+
+void
+thread_exit (void)
+{
+  syscall0 (SYS_THREAD_EXIT);
+  NOT_REACHED ();
+}
+
+void
+msleep (unsigned milliseconds)
+{
+  syscall1 (SYS_MSLEEP, milliseconds);
+}
+
+pid_t
+fork (void)
+{
+  return syscall0 (SYS_FORK);
+}
@@ -2,12 +2,21 @@
 #define __LIB_USER_SYSCALL_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <debug.h>
+#include <futex.h>
+#include <poll.h>
+#include <rusage.h>
+#include <uring.h>
 
 /* Process identifier. */
 typedef int pid_t;
 #define PID_ERROR ((pid_t) -1)
 
+/* Thread identifier. */
+typedef int tid_t;
+#define TID_ERROR ((tid_t) -1)
+
 /* Map region identifier. */
 typedef int mapid_t;
 #define MAP_FAILED ((mapid_t) -1)
@@ -15,6 +24,9 @@ typedef int mapid_t;
 /* Maximum characters in a filename written by readdir(). */
 #define READDIR_MAX_LEN 14
 
+/* Options for waitpid(). */
+#define WNOHANG 1               /* Don't block if no child has exited. */
+
 /* Typical return values from main() and arguments to exit(). */
 #define EXIT_SUCCESS 0          /* Successful execution. */
 #define EXIT_FAILURE 1          /* Unsuccessful execution. */
@@ -45,4 +57,22 @@ bool readdir (int fd, char name[READDIR_MAX_LEN + 1]);
 bool isdir (int fd);
 int inumber (int fd);
 
+/* Extensions. */
+int getrusage (int who, struct rusage *usage);
+pid_t spawn (const char *file);
+pid_t waitpid (pid_t, int *status, int options);
+int pipe (int fds[2]);
+int shm_create (size_t size);
+void *shm_attach (int id, void *addr);
+bool shm_detach (void *addr);
+struct uring *uring_setup (void *addr);
+int uring_enter (unsigned to_submit);
+int poll (struct pollfd *fds, unsigned nfds, int timeout);
+int futex (int *addr, int op, int val);
+tid_t thread_create (void (*fn) (void *), void *arg);
+int thread_join (tid_t);
+void thread_exit (void) NO_RETURN;
+void msleep (unsigned milliseconds);
+pid_t fork (void);
+
 #endif /* lib/user/syscall.h */
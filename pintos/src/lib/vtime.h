@@ -0,0 +1,28 @@
+#ifndef __LIB_VTIME_H
+#define __LIB_VTIME_H
+
+#include <stdint.h>
+
+/* Read-only page that the kernel maps into every user process
+   at VTIME_ADDR and updates on each timer tick, so that user
+   programs can read the time without a system call.  Shared by
+   the kernel and user programs.
+
+   The kernel makes SEQ odd while it updates the other fields
+   and even again afterward.  A reader retries if SEQ was odd or
+   changed while it read the page. */
+struct vtime
+  {
+    uint32_t seq;               /* Update sequence number. */
+    uint32_t freq;              /* Timer ticks per second. */
+    int64_t ticks;              /* Timer ticks since boot. */
+    uint64_t tsc;               /* Time-stamp counter at the last tick. */
+    uint64_t tsc_per_tick;      /* Recent TSC cycles per tick,
+                                   0 until measured. */
+  };
+
+/* User virtual address of the time page, just below the
+   usual start of program text. */
+#define VTIME_ADDR ((const volatile struct vtime *) 0x08000000)
+
+#endif /* lib/vtime.h */
@@ -0,0 +1,11 @@
+/* Child process for wait-any tests.
+   Exits with the status given as its argument, which the kernel
+   reports as "child-exit: exit(N)". */
+
+#include <stdlib.h>
+
+int
+main (int argc, char *argv[]) 
+{
+  return argc > 1 ? atoi (argv[1]) : 0;
+}
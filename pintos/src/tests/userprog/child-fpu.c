@@ -0,0 +1,21 @@
+/* Child process run by fpu test.
+
+   Loads its own value onto the x87 register stack, sleeps so
+   that other processes run, and exits with status 0 if the value
+   is still there. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+
+const char *test_name = "child-fpu";
+
+int
+main (void) 
+{
+  int in = 5678, out = 0;
+
+  asm volatile ("fninit; fildl %0" : : "m" (in));
+  msleep (50);
+  asm volatile ("fistpl %0" : "=m" (out));
+  return out == in ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+/* Child process run by futex test.
+
+   Attaches the shared memory segment whose id is given as the
+   first command-line argument and increments the counter in it
+   under the shared mutex. */
+
+#include <ctype.h>
+#include <mutex.h>
+#include <stdlib.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/userprog/futex.h"
+
+const char *test_name = "child-futex";
+
+int
+main (int argc UNUSED, char *argv[]) 
+{
+  struct futex_shared *s = SHARED_ADDR;
+  int i;
+
+  if (!isdigit (*argv[1]))
+    fail ("bad command-line arguments");
+  if (shm_attach (atoi (argv[1]), s) != s)
+    fail ("shm_attach failed");
+
+  for (i = 0; i < CHILD_ITERS; i++)
+    {
+      volatile int spin;
+      int counter;
+
+      mutex_lock (&s->mutex);
+      counter = s->counter;
+      for (spin = 0; spin < 100; spin++)
+        continue;
+      s->counter = counter + 1;
+      mutex_unlock (&s->mutex);
+    }
+  return 0;
+}
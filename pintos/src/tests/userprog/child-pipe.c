@@ -0,0 +1,39 @@
+/* Child process run by pipe test.
+
+   Writes a known byte pattern, more than fits in the pipe
+   buffer, to the pipe write end whose file descriptor is given
+   as the first command-line argument. */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <syscall.h>
+#include "tests/lib.h"
+
+const char *test_name = "child-pipe";
+
+/* Must match pipe.c. */
+#define CHILD_BYTES (3 * 4096 + 100)
+
+int
+main (int argc UNUSED, char *argv[]) 
+{
+  char buf[1000];
+  int fd, ofs;
+
+  if (!isdigit (*argv[1]))
+    fail ("bad command-line arguments");
+  fd = atoi (argv[1]);
+
+  for (ofs = 0; ofs < CHILD_BYTES; ofs += sizeof buf)
+    {
+      int size = CHILD_BYTES - ofs < (int) sizeof buf ? CHILD_BYTES - ofs
+                                                       : (int) sizeof buf;
+      int i;
+
+      for (i = 0; i < size; i++)
+        buf[i] = (ofs + i) % 251;
+      if (write (fd, buf, size) != size)
+        fail ("write to pipe failed");
+    }
+  return 0;
+}
@@ -0,0 +1,32 @@
+/* Child process run by shm test.
+
+   Attaches the shared memory segment whose id is given as the
+   first command-line argument, checks the pattern written by
+   the parent and increments every byte. */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <syscall.h>
+#include "tests/lib.h"
+
+const char *test_name = "child-shm";
+
+int
+main (int argc UNUSED, char *argv[]) 
+{
+  char *p;
+  int i;
+
+  if (!isdigit (*argv[1]))
+    fail ("bad command-line arguments");
+  p = shm_attach (atoi (argv[1]), (void *) 0x20000000);
+  if (p == NULL)
+    fail ("shm_attach failed");
+  for (i = 0; i < 2 * 4096; i++)
+    {
+      if (p[i] != (char) (i % 199))
+        fail ("byte %d is %d instead of %d", i, p[i], i % 199);
+      p[i]++;
+    }
+  return 0;
+}
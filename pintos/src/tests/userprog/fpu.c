@@ -0,0 +1,22 @@
+/* Leaves a value on the x87 register stack while a child
+   process uses the FPU, then checks that the value survived the
+   context switches. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  int in = 1234, out = 0;
+  pid_t child;
+
+  asm volatile ("fninit; fildl %0" : : "m" (in));
+  CHECK ((child = exec ("child-fpu")) != -1, "exec child-fpu");
+  CHECK (wait (child) == 0, "wait for child");
+  asm volatile ("fistpl %0" : "=m" (out));
+  if (out != in)
+    fail ("FPU register holds %d, expected %d", out, in);
+  msg ("FPU state preserved");
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(fpu) begin
+(fpu) exec child-fpu
+child-fpu: exit(0)
+(fpu) wait for child
+(fpu) FPU state preserved
+(fpu) end
+fpu: exit(0)
+EOF
+pass;
@@ -0,0 +1,51 @@
+/* Checks futex() directly, then has several child processes
+   increment a counter in shared memory under a mutex from
+   lib/user.  The parent holds the mutex while the children
+   start, so they have to sleep in FUTEX_WAIT until it is
+   released. */
+
+#include <mutex.h>
+#include <stdio.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/userprog/futex.h"
+
+void
+test_main (void) 
+{
+  struct futex_shared *s = SHARED_ADDR;
+  pid_t children[CHILD_CNT];
+  char cmd[32];
+  volatile int spin;
+  int id, i;
+
+  CHECK ((id = shm_create (sizeof *s)) >= 0, "shm_create");
+  CHECK (shm_attach (id, s) == s, "shm_attach");
+  mutex_init (&s->mutex);
+  s->counter = 0;
+
+  CHECK (futex (&s->counter, FUTEX_WAIT, 1) == -1,
+         "FUTEX_WAIT on changed value returns");
+  CHECK (futex (&s->counter, FUTEX_WAKE, 1) == 0,
+         "FUTEX_WAKE with no waiters");
+  CHECK (futex ((int *) 0x20000000, FUTEX_WAKE, 1) == -1,
+         "futex on unmapped address");
+
+  mutex_lock (&s->mutex);
+  snprintf (cmd, sizeof cmd, "child-futex %d", id);
+  for (i = 0; i < CHILD_CNT; i++)
+    if ((children[i] = spawn (cmd)) == PID_ERROR)
+      fail ("spawn failed");
+  for (spin = 0; spin < 1000000; spin++)
+    continue;
+  mutex_unlock (&s->mutex);
+  msg ("spawned children");
+
+  for (i = 0; i < CHILD_CNT; i++)
+    if (wait (children[i]) != 0)
+      fail ("child %d failed", i);
+  if (s->counter != CHILD_CNT * CHILD_ITERS)
+    fail ("counter is %d instead of %d", s->counter, CHILD_CNT * CHILD_ITERS);
+  msg ("counter is correct");
+}
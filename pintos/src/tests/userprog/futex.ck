@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(futex) begin
+(futex) shm_create
+(futex) shm_attach
+(futex) FUTEX_WAIT on changed value returns
+(futex) FUTEX_WAKE with no waiters
+(futex) futex on unmapped address
+(futex) spawned children
+(futex) counter is correct
+(futex) end
+EOF
+pass;
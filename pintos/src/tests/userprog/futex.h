@@ -0,0 +1,17 @@
+#ifndef TESTS_USERPROG_FUTEX_H
+#define TESTS_USERPROG_FUTEX_H
+
+#include <mutex.h>
+
+/* Shared memory used by futex test and child-futex. */
+struct futex_shared
+  {
+    struct mutex mutex;
+    int counter;
+  };
+
+#define SHARED_ADDR ((struct futex_shared *) 0x10000000)
+#define CHILD_CNT 3
+#define CHILD_ITERS 200
+
+#endif /* tests/userprog/futex.h */
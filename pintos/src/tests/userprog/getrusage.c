@@ -0,0 +1,74 @@
+/* Checks that getrusage() accounts for bytes moved by read()
+   and write(), that each disk sector a file access moves is
+   counted exactly once, and that a child's usage is added to the
+   parent's RUSAGE_CHILDREN totals once it has been waited for. */
+
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Reads and then rewrites the single sector of "sample.txt",
+   checking the sector counts of each access. */
+static void
+check_sectors (void)
+{
+  struct rusage before, after;
+  char buf[sizeof sample - 1];
+  int fd = open ("sample.txt");
+
+  if (fd < 2)
+    fail ("open \"sample.txt\" failed");
+
+  /* First pass brings in the code and buffer pages, so that the
+     measured passes take no page faults. */
+  if (read (fd, buf, sizeof buf) != (int) sizeof buf)
+    fail ("read \"sample.txt\" failed");
+
+  seek (fd, 0);
+  getrusage (RUSAGE_SELF, &before);
+  read (fd, buf, sizeof buf);
+  getrusage (RUSAGE_SELF, &after);
+  if (after.sectors_read - before.sectors_read != 1)
+    fail ("reading one sector counted %u sectors read",
+          after.sectors_read - before.sectors_read);
+
+  /* A partial sector is read, patched and written back. */
+  seek (fd, 0);
+  getrusage (RUSAGE_SELF, &before);
+  write (fd, sample, sizeof buf);
+  getrusage (RUSAGE_SELF, &after);
+  if (after.sectors_read - before.sectors_read != 1
+      || after.sectors_written - before.sectors_written != 1)
+    fail ("rewriting one sector counted %u sectors read, %u written",
+          after.sectors_read - before.sectors_read,
+          after.sectors_written - before.sectors_written);
+  close (fd);
+}
+
+void
+test_main (void) 
+{
+  struct rusage self, children;
+
+  check_file ("sample.txt", sample, sizeof sample - 1);
+  CHECK (getrusage (RUSAGE_SELF, &self) == 0, "getrusage (RUSAGE_SELF)");
+  if (self.bytes_read < sizeof sample - 1)
+    fail ("bytes_read is smaller than the file read");
+  if (self.bytes_written == 0)
+    fail ("bytes_written is zero after writing to the console");
+  check_sectors ();
+
+  CHECK (getrusage (RUSAGE_CHILDREN, &children) == 0,
+         "getrusage (RUSAGE_CHILDREN)");
+  if (children.bytes_written != 0)
+    fail ("children usage is not zero before any wait");
+
+  msg ("wait(exec()) = %d", wait (exec ("child-simple")));
+  CHECK (getrusage (RUSAGE_CHILDREN, &children) == 0,
+         "getrusage (RUSAGE_CHILDREN)");
+  if (children.bytes_written == 0)
+    fail ("child's console output is not in children usage");
+
+  CHECK (getrusage (2, &self) == -1, "getrusage (2) must fail");
+}
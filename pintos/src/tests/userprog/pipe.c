@@ -0,0 +1,56 @@
+/* Creates a pipe, passes data through it within one process,
+   then lets a child that inherited the write end send more
+   data than the pipe buffer holds.  Also checks that reading
+   returns 0 once all writers are gone and that writing fails
+   once all readers are gone. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Must match child-pipe.c. */
+#define CHILD_BYTES (3 * 4096 + 100)
+
+void
+test_main (void) 
+{
+  char buf[512];
+  char cmd[32];
+  int fds[2];
+  size_t total;
+  pid_t pid;
+  int n;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  CHECK (write (fds[1], "hello", 5) == 5, "write \"hello\"");
+  CHECK (read (fds[0], buf, sizeof buf) == 5 && !memcmp (buf, "hello", 5),
+         "read \"hello\"");
+
+  snprintf (cmd, sizeof cmd, "child-pipe %d", fds[1]);
+  CHECK ((pid = exec (cmd)) != PID_ERROR, "exec child-pipe");
+  close (fds[1]);
+
+  total = 0;
+  while ((n = read (fds[0], buf, sizeof buf)) > 0)
+    {
+      int i;
+      for (i = 0; i < n; i++)
+        if (buf[i] != (char) ((total + i) % 251))
+          fail ("byte %zu differs", total + i);
+      total += n;
+    }
+  if (n < 0)
+    fail ("read failed");
+  if (total != CHILD_BYTES)
+    fail ("read %zu bytes instead of %d", total, CHILD_BYTES);
+  msg ("read all data from child");
+  CHECK (wait (pid) == 0, "wait for child");
+  close (fds[0]);
+
+  CHECK (pipe (fds) == 0, "pipe");
+  close (fds[0]);
+  CHECK (write (fds[1], "x", 1) == -1, "write with no reader");
+  close (fds[1]);
+}
@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pipe) begin
+(pipe) pipe
+(pipe) write "hello"
+(pipe) read "hello"
+(pipe) exec child-pipe
+child-pipe: exit(0)
+(pipe) read all data from child
+(pipe) wait for child
+(pipe) pipe
+(pipe) write with no reader
+(pipe) end
+pipe: exit(0)
+EOF
+pass;
@@ -0,0 +1,44 @@
+/* Polls both ends of a pipe, stdout and a closed fd, checking
+   that readiness follows the pipe's contents and that the read
+   end reports POLLHUP once the write end is closed.  Also checks
+   that polling an empty pipe times out. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  struct pollfd pfd[4];
+  int fds[2];
+  char c;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  pfd[0].fd = fds[0];
+  pfd[0].events = POLLIN;
+  pfd[1].fd = fds[1];
+  pfd[1].events = POLLOUT;
+  pfd[2].fd = 1;
+  pfd[2].events = POLLOUT;
+  pfd[3].fd = 100;
+  pfd[3].events = POLLIN;
+
+  CHECK (poll (pfd, 4, 0) == 3, "poll empty pipe");
+  if (pfd[0].revents != 0 || pfd[1].revents != POLLOUT
+      || pfd[2].revents != POLLOUT || pfd[3].revents != POLLNVAL)
+    fail ("wrong revents %#x %#x %#x %#x", pfd[0].revents,
+          pfd[1].revents, pfd[2].revents, pfd[3].revents);
+
+  CHECK (poll (pfd, 1, 50) == 0, "poll read end times out");
+
+  CHECK (write (fds[1], "x", 1) == 1, "write one byte");
+  CHECK (poll (pfd, 1, -1) == 1 && pfd[0].revents == POLLIN,
+         "poll read end is readable");
+
+  close (fds[1]);
+  CHECK (read (fds[0], &c, 1) == 1 && c == 'x', "read one byte");
+  CHECK (poll (pfd, 1, -1) == 1 && pfd[0].revents == POLLHUP,
+         "poll read end after writer closed");
+  close (fds[0]);
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(poll) begin
+(poll) pipe
+(poll) poll empty pipe
+(poll) poll read end times out
+(poll) write one byte
+(poll) poll read end is readable
+(poll) read one byte
+(poll) poll read end after writer closed
+(poll) end
+poll: exit(0)
+EOF
+pass;
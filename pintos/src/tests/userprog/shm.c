@@ -0,0 +1,40 @@
+/* Creates a two-page shared memory segment, fills it, and lets
+   a child attach the same segment at a different address and
+   answer through it.  Also checks that a segment cannot be
+   attached on top of pages that are already mapped. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define SHM_ADDR ((char *) 0x10000000)
+
+void
+test_main (void) 
+{
+  char cmd[32];
+  char *p;
+  int id;
+  int i;
+
+  CHECK ((id = shm_create (2 * 4096)) >= 0, "shm_create");
+  CHECK ((p = shm_attach (id, SHM_ADDR)) == SHM_ADDR, "shm_attach");
+  for (i = 0; i < 2 * 4096; i++)
+    p[i] = i % 199;
+
+  CHECK (shm_attach (id, SHM_ADDR + 4096) == NULL, "attach over mapped page");
+  CHECK (shm_attach (id + 100, SHM_ADDR + 0x100000) == NULL,
+         "attach bad id");
+
+  snprintf (cmd, sizeof cmd, "child-shm %d", id);
+  CHECK (wait (exec (cmd)) == 0, "wait for child-shm");
+  for (i = 0; i < 2 * 4096; i++)
+    if (p[i] != (char) (i % 199 + 1))
+      fail ("byte %d is %d instead of %d", i, p[i], i % 199 + 1);
+  msg ("child's updates are visible");
+
+  CHECK (shm_detach (p), "shm_detach");
+  CHECK (!shm_detach (p), "shm_detach again");
+}
@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(shm) begin
+(shm) shm_create
+(shm) shm_attach
+(shm) attach over mapped page
+(shm) attach bad id
+(shm) wait for child-shm
+child-shm: exit(0)
+(shm) child's updates are visible
+(shm) shm_detach
+(shm) shm_detach again
+(shm) end
+shm: exit(0)
+EOF
+pass;
@@ -0,0 +1,23 @@
+/* Starts children with spawn(), which does not wait for the
+   child to load, and collects the results with wait().  A
+   child that fails to load must be reported by wait() as -1. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  pid_t pid;
+
+  pid = spawn ("child-simple");
+  if (pid == PID_ERROR)
+    fail ("spawn(\"child-simple\") returned PID_ERROR");
+  msg ("wait(spawn(\"child-simple\")) = %d", wait (pid));
+
+  pid = spawn ("no-such-file");
+  if (pid == PID_ERROR)
+    fail ("spawn(\"no-such-file\") returned PID_ERROR");
+  msg ("wait(spawn(\"no-such-file\")) = %d", wait (pid));
+}
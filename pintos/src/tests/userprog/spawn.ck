@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(spawn) begin
+(child-simple) run
+child-simple: exit(81)
+(spawn) wait(spawn("child-simple")) = 81
+load: no-such-file: open failed
+(spawn) wait(spawn("no-such-file")) = -1
+(spawn) end
+spawn: exit(0)
+EOF
+pass;
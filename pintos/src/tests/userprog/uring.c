@@ -0,0 +1,80 @@
+/* Maps a system call ring and runs file operations through it
+   in batches: opens sample.txt, then reads it, seeks back, reads
+   again and closes it with a single uring_enter().  A request
+   for a system call that the ring does not accept completes
+   with -1 without affecting the others. */
+
+#include <string.h>
+#include <syscall.h>
+#include <syscall-nr.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define RING_ADDR ((void *) 0x10000000)
+
+static struct uring *ring;
+
+static void
+queue (int op, uint32_t a0, uint32_t a1, uint32_t a2)
+{
+  struct uring_sqe *sqe = &ring->sq[ring->sq_tail % URING_SQ_ENTRIES];
+  sqe->op = op;
+  sqe->args[0] = a0;
+  sqe->args[1] = a1;
+  sqe->args[2] = a2;
+  sqe->user_data = ring->sq_tail;
+  ring->sq_tail++;
+}
+
+static int
+complete (uint32_t user_data)
+{
+  struct uring_cqe *cqe;
+
+  if (ring->cq_head == ring->cq_tail)
+    fail ("missing completion for request %u", user_data);
+  cqe = &ring->cq[ring->cq_head++ % URING_CQ_ENTRIES];
+  if (cqe->user_data != user_data)
+    fail ("completion for request %u instead of %u",
+          cqe->user_data, user_data);
+  return cqe->res;
+}
+
+void
+test_main (void) 
+{
+  char buf1[sizeof sample];
+  char buf2[16];
+  int fd;
+
+  CHECK ((ring = uring_setup (RING_ADDR)) == RING_ADDR, "uring_setup");
+  CHECK (uring_setup ((char *) RING_ADDR + 4096) == NULL,
+         "second uring_setup fails");
+
+  queue (SYS_OPEN, (uint32_t) "sample.txt", 0, 0);
+  CHECK (uring_enter (1) == 1, "submit open");
+  CHECK ((fd = complete (0)) > 1, "open \"sample.txt\"");
+
+  queue (SYS_READ, fd, (uint32_t) buf1, sizeof sample - 1);
+  queue (SYS_SEEK, fd, 0, 0);
+  queue (SYS_READ, fd, (uint32_t) buf2, sizeof buf2);
+  queue (SYS_EXEC, (uint32_t) "child-simple", 0, 0);
+  queue (SYS_CLOSE, fd, 0, 0);
+  CHECK (uring_enter (5) == 5, "submit read, seek, read, exec, close");
+
+  if (complete (1) != sizeof sample - 1)
+    fail ("first read returned wrong size");
+  compare_bytes (buf1, sample, sizeof sample - 1, 0, "sample.txt");
+  complete (2);
+  if (complete (3) != sizeof buf2)
+    fail ("second read returned wrong size");
+  compare_bytes (buf2, sample, sizeof buf2, 0, "sample.txt");
+  if (complete (4) != -1)
+    fail ("exec through the ring was not rejected");
+  complete (5);
+  msg ("completions are correct");
+
+  CHECK (uring_enter (1) == 0, "empty submission ring");
+  CHECK (read (fd, buf2, 1) == -1, "fd was closed by the ring");
+}
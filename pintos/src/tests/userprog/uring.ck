@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(uring) begin
+(uring) uring_setup
+(uring) second uring_setup fails
+(uring) submit open
+(uring) open "sample.txt"
+(uring) submit read, seek, read, exec, close
+(uring) completions are correct
+(uring) empty submission ring
+(uring) fd was closed by the ring
+(uring) end
+uring: exit(0)
+EOF
+pass;
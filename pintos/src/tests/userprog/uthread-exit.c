@@ -0,0 +1,21 @@
+/* Calls exit() from a second thread while the main thread
+   spins.  The whole process must terminate with the status
+   passed to exit(). */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static void
+worker (void *aux UNUSED) 
+{
+  exit (42);
+}
+
+void
+test_main (void) 
+{
+  CHECK (thread_create (worker, NULL) != TID_ERROR, "thread_create");
+  for (;;)
+    continue;
+}
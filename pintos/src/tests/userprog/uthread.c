@@ -0,0 +1,75 @@
+/* Starts several threads in one process.  They share globals,
+   the fd table and a mutex from lib/user, and each runs on its
+   own stack.  Also checks that a thread can only be joined
+   once. */
+
+#include <mutex.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define THREAD_CNT 4
+#define ITERS 1000
+
+static struct mutex mutex = MUTEX_INITIALIZER;
+static int counter;
+static int fds[2];
+static void *stacks[THREAD_CNT];
+
+static void
+worker (void *aux) 
+{
+  int id = (int) aux;
+  char c = 'a' + id;
+  int local;
+  int i;
+
+  stacks[id] = &local;
+  for (i = 0; i < ITERS; i++)
+    {
+      mutex_lock (&mutex);
+      counter++;
+      mutex_unlock (&mutex);
+    }
+  if (write (fds[1], &c, 1) != 1)
+    fail ("thread %d: write to pipe failed", id);
+}
+
+void
+test_main (void) 
+{
+  tid_t tids[THREAD_CNT];
+  char buf[THREAD_CNT];
+  int seen = 0;
+  int i, j;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  for (i = 0; i < THREAD_CNT; i++)
+    if ((tids[i] = thread_create (worker, (void *) i)) == TID_ERROR)
+      fail ("thread_create failed");
+  msg ("created %d threads", THREAD_CNT);
+
+  for (i = 0; i < THREAD_CNT; i++)
+    if (thread_join (tids[i]) != 0)
+      fail ("thread_join failed");
+  msg ("joined %d threads", THREAD_CNT);
+  CHECK (thread_join (tids[0]) == -1, "second thread_join fails");
+
+  if (counter != THREAD_CNT * ITERS)
+    fail ("counter is %d instead of %d", counter, THREAD_CNT * ITERS);
+  msg ("counter is correct");
+
+  if (read (fds[0], buf, THREAD_CNT) != THREAD_CNT)
+    fail ("wrong number of bytes in pipe");
+  for (i = 0; i < THREAD_CNT; i++)
+    seen |= 1 << (buf[i] - 'a');
+  if (seen != (1 << THREAD_CNT) - 1)
+    fail ("not every thread wrote to the shared pipe");
+  msg ("every thread wrote to the shared pipe");
+
+  for (i = 0; i < THREAD_CNT; i++)
+    for (j = i + 1; j < THREAD_CNT; j++)
+      if (stacks[i] == stacks[j])
+        fail ("threads %d and %d shared a stack", i, j);
+  msg ("threads ran on separate stacks");
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(uthread) begin
+(uthread) pipe
+(uthread) created 4 threads
+(uthread) joined 4 threads
+(uthread) second thread_join fails
+(uthread) counter is correct
+(uthread) every thread wrote to the shared pipe
+(uthread) threads ran on separate stacks
+(uthread) end
+uthread: exit(0)
+EOF
+pass;
@@ -0,0 +1,24 @@
+/* Reads the clock from the kernel's time page around an
+   msleep() call, then tries to write to the time page, which
+   must kill the process. */
+
+#include <clock.h>
+#include <syscall.h>
+#include <vtime.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  int64_t start_ticks = clock_ticks ();
+  uint64_t start_ns = clock_ns ();
+
+  msleep (100);
+  CHECK (clock_ticks () > start_ticks, "ticks advance across msleep");
+  CHECK (clock_ns () - start_ns >= 90000000, "at least 90 ms elapsed");
+
+  msg ("write to time page");
+  ((volatile struct vtime *) VTIME_ADDR)->ticks = 0;
+  fail ("should have exited with -1");
+}
@@ -0,0 +1,12 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_USER_FAULTS => 1, [<<'EOF']);
+(vtime) begin
+(vtime) ticks advance across msleep
+(vtime) at least 90 ms elapsed
+(vtime) write to time page
+vtime: exit(-1)
+EOF
+pass;
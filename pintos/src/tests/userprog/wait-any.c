@@ -0,0 +1,55 @@
+/* Starts several children and reaps them with waitpid(-1),
+   which returns whichever child finishes first, then checks
+   that WNOHANG polling and the no-children case behave. */
+
+#include <stdio.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 4
+
+void
+test_main (void) 
+{
+  pid_t children[CHILD_CNT];
+  bool reaped[CHILD_CNT];
+  char cmd[32];
+  int status;
+  pid_t pid;
+  int i;
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      snprintf (cmd, sizeof cmd, "child-exit %d", i + 10);
+      children[i] = exec (cmd);
+      if (children[i] == PID_ERROR)
+        fail ("exec \"%s\" failed", cmd);
+      reaped[i] = false;
+    }
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      int j;
+
+      pid = waitpid (-1, &status, 0);
+      for (j = 0; j < CHILD_CNT; j++)
+        if (children[j] == pid)
+          break;
+      if (j == CHILD_CNT || reaped[j])
+        fail ("waitpid(-1) returned unexpected pid %d", pid);
+      if (status != j + 10)
+        fail ("child %d exited with %d, expected %d", j, status, j + 10);
+      reaped[j] = true;
+    }
+  msg ("reaped %d children with waitpid(-1)", CHILD_CNT);
+
+  pid = exec ("child-exit 42");
+  while (waitpid (pid, &status, WNOHANG) == 0)
+    continue;
+  msg ("polled child with WNOHANG, status %d", status);
+
+  msg ("waitpid(-1) without children = %d", waitpid (-1, &status, 0));
+  msg ("waitpid(-1, WNOHANG) without children = %d",
+       waitpid (-1, &status, WNOHANG));
+}
@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(wait-any) begin
+(wait-any) reaped 4 children with waitpid(-1)
+(wait-any) polled child with WNOHANG, status 42
+(wait-any) waitpid(-1) without children = -1
+(wait-any) waitpid(-1, WNOHANG) without children = -1
+(wait-any) end
+EOF
+pass;
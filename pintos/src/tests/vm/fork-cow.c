@@ -0,0 +1,45 @@
+/* Forks, then has the child overwrite a global array and a
+   stack buffer that it shares copy-on-write with the parent.
+   The child must see the parent's data until it writes, and the
+   parent must not see the child's writes. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define SIZE (64 * 1024)
+
+static char buf[SIZE];
+
+void
+test_main (void)
+{
+  char local[256];
+  pid_t pid;
+  size_t i;
+
+  memset (buf, 'p', SIZE);
+  memset (local, 'p', sizeof local);
+
+  pid = fork ();
+  if (pid == 0)
+    {
+      for (i = 0; i < SIZE; i++)
+        if (buf[i] != 'p')
+          fail ("child read bad data at offset %zu", i);
+      memset (buf, 'c', SIZE);
+      memset (local, 'c', sizeof local);
+      exit (buf[SIZE - 1] == 'c' && local[0] == 'c' ? 81 : 1);
+    }
+  CHECK (pid > 0, "fork");
+  CHECK (wait (pid) == 81, "wait for child");
+
+  for (i = 0; i < SIZE; i++)
+    if (buf[i] != 'p')
+      fail ("parent's array changed at offset %zu", i);
+  for (i = 0; i < sizeof local; i++)
+    if (local[i] != 'p')
+      fail ("parent's stack changed at offset %zu", i);
+  msg ("parent's memory unchanged");
+}
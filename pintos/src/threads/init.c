@@ -25,14 +25,22 @@
 #ifdef USERPROG
 #include "userprog/process.h"
 #include "userprog/exception.h"
+#include "userprog/fpu.h"
 #include "userprog/gdt.h"
 #include "userprog/syscall.h"
 #include "userprog/tss.h"
 #else
 #include "tests/threads/tests.h"
 #endif
+#ifdef VM
+#include "vm/frame.h"
+#include "vm/merge.h"
+#include "vm/page.h"
+#include "vm/swap.h"
+#endif
 #ifdef FILESYS
 #include "devices/block.h"
+#include "devices/zram.h"
 #include "devices/ide.h"
 #include "filesys/filesys.h"
 #include "filesys/fsutil.h"
@@ -51,6 +59,9 @@ static const char *filesys_bdev_name;
 static const char *scratch_bdev_name;
 #ifdef VM
 static const char *swap_bdev_name;
+
+/* -zram: Memory for compressed swap, in kB. */
+static size_t zram_kb = ZRAM_DEFAULT;
 #endif
 #endif /* FILESYS */
 
@@ -113,6 +124,11 @@ main (void)
 #ifdef USERPROG
   exception_init ();
   syscall_init ();
+  fpu_init ();
+#endif
+#ifdef VM
+  page_init ();
+  frame_init ();
 #endif
 
   /* Start thread scheduler and enable interrupts. */
@@ -126,6 +142,11 @@ main (void)
   locate_block_devices ();
   filesys_init (format_filesys);
 #endif
+#ifdef VM
+  zram_init (zram_kb);
+  swap_init ();
+  merge_init ();
+#endif
 
   printf ("Boot complete.\n");
   
@@ -150,16 +171,31 @@ bss_init (void)
   memset (&_start_bss, 0, &_end_bss - &_start_bss);
 }
 
+/* CPUID feature and CR4 bits for 4 MB pages.  See [IA32-v3a]
+   3.7.3 "Mixing 4-KByte and 4-MByte Pages". */
+#define CPUID_PSE 0x00000008    /* CPUID.1:EDX, 4 MB pages supported. */
+#define CR4_PSE 0x00000010      /* CR4, enable 4 MB pages. */
+
 /* Populates the base page directory and page table with the
    kernel virtual mapping, and then sets up the CPU to use the
    new page directory.  Points init_page_dir to the page
-   directory it creates. */
+   directory it creates.
+
+   If the CPU supports it, each 4 MB of RAM is mapped by a single
+   PDE, which saves its page table and lots of TLB entries.  The
+   4 MB holding the read-only kernel text, and a partial 4 MB at
+   the end of RAM, still get page tables. */
 static void
 paging_init (void)
 {
   uint32_t *pd, *pt;
   size_t page;
   extern char _start, _end_kernel_text;
+  uint32_t eax = 1, ebx, ecx, edx;
+  bool pse;
+
+  asm volatile ("cpuid" : "+a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx));
+  pse = (edx & CPUID_PSE) != 0;
 
   pd = init_page_dir = palloc_get_page (PAL_ASSERT | PAL_ZERO);
   pt = NULL;
@@ -173,6 +209,16 @@ paging_init (void)
 
       if (pd[pde_idx] == 0)
         {
+          char *end = vaddr + PTSPAN;
+
+          if (pse && pte_idx == 0
+              && page + PTSPAN / PGSIZE <= init_ram_pages
+              && (end <= &_start || vaddr >= &_end_kernel_text))
+            {
+              pd[pde_idx] = pde_create_kernel_big (vaddr, true);
+              page += PTSPAN / PGSIZE - 1;
+              continue;
+            }
           pt = palloc_get_page (PAL_ASSERT | PAL_ZERO);
           pd[pde_idx] = pde_create (pt);
         }
@@ -180,6 +226,15 @@ paging_init (void)
       pt[pte_idx] = pte_create_kernel (vaddr, !in_kernel_text);
     }
 
+  /* 4 MB pages must be enabled before any PDE that maps one is
+     used. */
+  if (pse)
+    {
+      uint32_t cr4;
+      asm volatile ("movl %%cr4, %0" : "=r" (cr4));
+      asm volatile ("movl %0, %%cr4" : : "r" (cr4 | CR4_PSE));
+    }
+
   /* Store the physical address of the page directory into CR3
      aka PDBR (page directory base register).  This activates our
      new page tables immediately.  See [IA32-v2a] "MOV--Move
@@ -250,6 +305,8 @@ parse_options (char **argv)
 #ifdef VM
       else if (!strcmp (name, "-swap"))
         swap_bdev_name = value;
+      else if (!strcmp (name, "-zram"))
+        zram_kb = atoi (value);
 #endif
 #endif
       else if (!strcmp (name, "-rs"))
@@ -257,6 +314,8 @@ parse_options (char **argv)
       else if (!strcmp (name, "-mlfqs"))
         thread_mlfqs = true;
 #ifdef USERPROG
+      else if (!strcmp (name, "-strace"))
+        syscall_strace = value != NULL ? value : "";
       else if (!strcmp (name, "-ul"))
         user_page_limit = atoi (value);
 #endif
@@ -375,11 +434,13 @@ usage (void)
           "  -scratch=BDEV      Use BDEV for scratch instead of default.\n"
 #ifdef VM
           "  -swap=BDEV         Use BDEV for swap instead of default.\n"
+          "  -zram=KB           Keep up to KB kB of compressed swap in RAM.\n"
 #endif
 #endif
           "  -rs=SEED           Set random number seed to SEED.\n"
           "  -mlfqs             Use multi-level feedback queue scheduler.\n"
 #ifdef USERPROG
+          "  -strace[=PROG,...] Trace system calls of PROGs (default: all).\n"
           "  -ul=COUNT          Limit user memory to COUNT pages.\n"
 #endif
           );
@@ -8,6 +8,10 @@
 #include "threads/io.h"
 #include "threads/thread.h"
 #include "threads/vaddr.h"
+#ifdef USERPROG
+#include "userprog/gdt.h"
+#include "userprog/process.h"
+#endif
 #include "devices/timer.h"
 
 /* Programmable Interrupt Controller (PIC) registers.
@@ -385,6 +389,13 @@ intr_handler (struct intr_frame *frame)
 
       if (yield_on_return) 
         thread_yield (); 
+
+#ifdef USERPROG
+      /* Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 같은 프로세스의 다른 스레드가 exit()했으면
+         유저 모드로 돌아가기 전에 종료. */
+      if (frame->cs == SEL_UCSEG)
+        process_check_exit ();
+#endif
     }
 }
 
@@ -12,7 +12,10 @@
 #include "threads/synch.h"
 #include "threads/vaddr.h"
 #ifdef USERPROG
+#include "userprog/gdt.h"
+#include "userprog/fpu.h"
 #include "userprog/process.h"
+#include "userprog/syscall.h"
 #endif
 
 /* Random value for struct thread's `magic' member.
@@ -123,12 +126,21 @@ thread_start (void)
 }
 
 /* Called by the timer interrupt handler at each timer tick.
-   Thus, this function runs in an external interrupt context. */
+   Thus, this function runs in an external interrupt context.
+   F is the interrupted context. */
 void
-thread_tick (void) 
+thread_tick (struct intr_frame *f UNUSED) 
 {
   struct thread *t = thread_current ();
 
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 스레드별 사용 시간 (유저 모드에서 인터럽트 됐는지로 구분)
+#ifdef USERPROG
+  if (f->cs == SEL_UCSEG)
+    t->ru.user_ticks++;
+  else
+#endif
+    t->ru.kernel_ticks++;
+
   /* Update statistics. */
   if (t == idle_thread)
     idle_ticks++;
@@ -191,6 +203,9 @@ thread_create (const char *name, int priority,
 
   t->fd_idx = 2;  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table index 초기화
   memset(t->fd_table, 0, sizeof(t->fd_table)); // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table 초기화
+#ifdef USERPROG
+  fd_inherit(t);  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 파이프 fd는 아직 자식이 실행되기 전에 물려줌
+#endif
 
   t->parent = thread_current();  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 자식의 parent 설정
   list_push_back(&thread_current()->child_list, &t->child);  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 자식 프로세스 리스트에 추가
@@ -377,6 +392,7 @@ thread_exit (void)
 
 #ifdef USERPROG
   process_exit ();
+  fpu_exit ();
 #endif
 
   /* Remove thread from all threads list, set our status to dying,
@@ -569,8 +585,19 @@ init_thread (struct thread *t, const char *name, int priority)
 
   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 초기화
   list_init(&t->child_list);
+  list_init(&t->exited_list);
+  list_init(&t->shm_list);
+  list_init(&t->uthread_list);
+#ifdef VM
+  list_init(&t->mmaps);
+#endif
+  sema_init(&t->s_uthread_exit, 0);
+  sema_init(&t->s_join, 0);
+  lock_init(&t->proc_lock);
+  t->leader = t;
   sema_init(&t->s_load, 0);
   sema_init(&t->s_wait, 0);
+  sema_init(&t->s_child_exit, 0);
   t->is_wait = false;
   t->is_load = false;
 }
@@ -669,7 +696,14 @@ schedule (void)
   ASSERT (is_thread (next));
 
   if (cur != next)
-    prev = switch_threads (cur, next);
+    {
+      // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - block돼서 나가면 voluntary, ready 상태로 밀려나면 involuntary
+      if (cur->status == THREAD_READY)
+        cur->ru.nivcsw++;
+      else if (cur->status == THREAD_BLOCKED)
+        cur->ru.nvcsw++;
+      prev = switch_threads (cur, next);
+    }
   thread_schedule_tail (prev);
 }
 
@@ -2,8 +2,10 @@
 #define THREADS_THREAD_H
 
 #include <debug.h>
+#include <hash.h>
 #include <list.h>
 #include <stdint.h>
+#include <rusage.h>
 #include "synch.h"  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - semaphores (sema_init, sema_down, sema_up...)
 
 /* States in a thread's life cycle. */
@@ -104,7 +106,7 @@ struct thread
 
     // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - File Discripter Table
     int fd_idx;  // 0 = stdin, 1 = stdout, 2 = file descriptor 시작
-    struct file *fd_table[FD_MAX];  // fd_table[0] = stdin, fd_table[1] = stdout
+    struct fd *fd_table[FD_MAX];  // fd_table[0] = stdin, fd_table[1] = stdout (파일 또는 파이프, userprog/syscall.c)
 
    // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 새로운 thread 구조체 변수
    struct thread *parent;  // 부모 스레드
@@ -116,12 +118,48 @@ struct thread
    bool is_load;  // 자식의 load 성공 여부를 부모에게 전달ㄴ
 
    struct semaphore s_wait;  // wait()에서 부모가 자식의 종료를 대기
-   bool is_wait;  // 중복 wait 호출 방지용 플래그
+
+   struct list exited_list;        // 종료했지만 아직 회수 안 한 자식들 (completion queue)
+   struct list_elem exit_elem;     // 부모의 exited_list 요소
+   struct semaphore s_child_exit;  // 자식 중 누군가 종료하면 up (wait-any에서 대기)
+   bool is_wait;  // 부모가 wait()으로 회수 끝냄 -> 죽을 때 struct thread 바로 해제
 
    struct file *cur_file;  // 실행 중인 파일에 대한 포인터, 쓰기 방지
+
+   struct list shm_list;  // 만들었거나 attach한 공유 메모리 세그먼트 (userprog/shm.c)
+   struct uring *uring;   // uring_setup()으로 매핑한 요청 ring의 커널 주소 (userprog/uring.c)
+   struct lock proc_lock; // (leader) fd_table, fd_idx, shm_list, mmaps, uring 보호 (유저 스레드끼리)
+
+   // 유저 스레드 (thread_create syscall)
+   // 같은 프로세스의 스레드들은 leader의 pagedir, fd_table, cur_file, shm_list, uring을 같이 씀
+   struct thread *leader;          // 프로세스의 첫 스레드 (첫 스레드면 자기 자신)
+   bool exiting;                   // (leader) 프로세스 종료 중 -> 다른 스레드도 종료
+   struct list uthread_list;       // (leader) 아직 join 안 한 유저 스레드들
+   struct list_elem uthread_elem;  // leader의 uthread_list 요소
+   int uthread_cnt;                // (leader) 살아있는 유저 스레드 수
+   uint32_t uthread_stacks;        // (leader) 사용 중인 유저 스레드 스택 자리 (bitmap)
+   int uthread_slot;               // 이 유저 스레드의 스택 자리
+   struct semaphore s_uthread_exit;  // (leader) 유저 스레드가 종료하면 up
+   struct thread *joiner;          // 이 스레드를 join 중인 스레드
+   struct semaphore s_join;        // join하는 스레드가 기다림 (상대가 끝나거나 프로세스가 종료하면 up)
+   struct futex_waiter *futex_waiter;  // FUTEX_WAIT 중이면 기다리는 곳 (userprog/futex.c)
+
+   void *fpu;  // FXSAVE 영역, FPU를 처음 쓸 때 할당 (userprog/fpu.c)
+   uint8_t *io_buf;  // read()/write()가 거쳐가는 커널 페이지, 처음 쓸 때 할당 (process_exit()에서 해제)
+
+   struct syscall_stats *sc_stats;  // -strace 대상일 때만 할당되는 syscall 통계
+
+   struct rusage ru;           // 이 스레드의 자원 사용량 (getrusage)
+   struct rusage ru_children;  // wait()으로 회수한 자식들의 자원 사용량 합
    // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
 
    uint32_t *pagedir;                  /* Page directory. */
+#ifdef VM
+   struct hash pages;  // (leader) 보조 페이지 테이블 (vm/page.c)
+   void *user_esp;     // syscall에 들어올 때의 유저 esp (커널에서 난 fault의 스택 확장 판단용)
+   struct list mmaps;  // (leader) mmap()한 매핑들 (vm/mmap.c)
+   int next_mapid;     // (leader) 다음 mmap()이 돌려줄 mapid
+#endif
 #ifdef USERPROG
     /* Owned by userprog/process.c. */
     #endif
@@ -138,7 +176,8 @@ extern bool thread_mlfqs;
 void thread_init (void);
 void thread_start (void);
 
-void thread_tick (void);
+struct intr_frame;
+void thread_tick (struct intr_frame *);
 void thread_print_stats (void);
 
 typedef void thread_func (void *aux);
@@ -0,0 +1,105 @@
+#include "userprog/elf-cache.h"
+#include <debug.h>
+#include <list.h>
+#include "filesys/file.h"
+#include "filesys/inode.h"
+#include "threads/malloc.h"
+#include "threads/synch.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 같은 실행 파일을 여러 번 exec할 때 ELF 헤더를 다시 읽고 파싱하지 않도록
+// inode별로 파싱 결과를 기억해 둠
+// - 엔트리가 inode를 열어두고 있어서 in-memory inode (와 write_gen)가 유지됨
+// - 파일에 쓰기가 있었으면 write_gen이 달라짐 -> 그 엔트리는 버림
+// - 최근에 쓴 ELF_CACHE_SIZE개만 유지 (LRU), 지워진 파일도 밀려날 때 닫힘
+
+#define ELF_CACHE_SIZE 8
+
+struct elf_cache_entry
+  {
+    struct inode *inode;        /* 실행 파일 (inode_reopen()으로 열어둠). */
+    unsigned write_gen;         /* 파싱할 때의 inode_write_gen(). */
+    struct elf_image image;     /* 파싱 결과. */
+    struct list_elem elem;      /* elf_cache 요소, 앞쪽이 최근. */
+  };
+
+static struct list elf_cache = LIST_INITIALIZER (elf_cache);
+static size_t elf_cache_cnt;
+static struct lock elf_cache_lock;
+
+static void entry_free (struct elf_cache_entry *);
+
+void
+elf_cache_init (void)
+{
+  lock_init (&elf_cache_lock);
+}
+
+/* If FILE's executable headers are cached and FILE has not been
+   written since, copies them into *IMAGE and returns true.
+   Otherwise returns false. */
+bool
+elf_cache_lookup (struct file *file, struct elf_image *image)
+{
+  struct inode *inode = file_get_inode (file);
+  struct list_elem *e;
+  bool found = false;
+
+  lock_acquire (&elf_cache_lock);
+  for (e = list_begin (&elf_cache); e != list_end (&elf_cache);
+       e = list_next (e))
+    {
+      struct elf_cache_entry *ce = list_entry (e, struct elf_cache_entry,
+                                               elem);
+      if (ce->inode != inode)
+        continue;
+
+      list_remove (&ce->elem);
+      if (ce->write_gen != inode_write_gen (inode))
+        {
+          /* Stale: the file was rewritten. */
+          elf_cache_cnt--;
+          entry_free (ce);
+        }
+      else
+        {
+          list_push_front (&elf_cache, &ce->elem);
+          *image = ce->image;
+          found = true;
+        }
+      break;
+    }
+  lock_release (&elf_cache_lock);
+  return found;
+}
+
+/* Remembers IMAGE as the parsed headers of FILE, evicting the
+   least recently used entry if the cache is full. */
+void
+elf_cache_insert (struct file *file, const struct elf_image *image)
+{
+  struct inode *inode = file_get_inode (file);
+  struct elf_cache_entry *ce = malloc (sizeof *ce);
+  if (ce == NULL)
+    return;
+  ce->inode = inode_reopen (inode);
+  ce->write_gen = inode_write_gen (inode);
+  ce->image = *image;
+
+  lock_acquire (&elf_cache_lock);
+  list_push_front (&elf_cache, &ce->elem);
+  if (++elf_cache_cnt > ELF_CACHE_SIZE)
+    {
+      elf_cache_cnt--;
+      entry_free (list_entry (list_pop_back (&elf_cache),
+                              struct elf_cache_entry, elem));
+    }
+  lock_release (&elf_cache_lock);
+}
+
+static void
+entry_free (struct elf_cache_entry *ce)
+{
+  inode_close (ce->inode);
+  free (ce);
+}
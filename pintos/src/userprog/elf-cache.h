@@ -0,0 +1,33 @@
+#ifndef USERPROG_ELF_CACHE_H
+#define USERPROG_ELF_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct file;
+
+/* Most PT_LOAD segments an executable may have. */
+#define ELF_SEG_MAX 16
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - load()가 ELF 헤더를 파싱하고 검사한 결과 (userprog/process.c)
+struct elf_segment
+  {
+    uint32_t file_page;         /* 읽기 시작할 파일 오프셋 (페이지 정렬). */
+    uint32_t mem_page;          /* 매핑할 유저 주소 (페이지 정렬). */
+    uint32_t read_bytes;        /* 파일에서 읽을 바이트 수. */
+    uint32_t zero_bytes;        /* 그 뒤에 0으로 채울 바이트 수. */
+    bool writable;
+  };
+
+struct elf_image
+  {
+    uint32_t entry;             /* 시작 주소. */
+    int seg_cnt;
+    struct elf_segment segs[ELF_SEG_MAX];
+  };
+
+void elf_cache_init (void);
+bool elf_cache_lookup (struct file *, struct elf_image *);
+void elf_cache_insert (struct file *, const struct elf_image *);
+
+#endif /* userprog/elf-cache.h */
@@ -6,12 +6,28 @@
 #include "threads/thread.h"
 #include "threads/vaddr.h"  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ is_user_vaddr() 사용
 #include "userprog/syscall.h"  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ exit() 사용
+#include "userprog/fpu.h"
+#ifdef VM
+#include "vm/page.h"
+#endif
 
 /* Number of page faults processed. */
 static long long page_fault_cnt;
 
+/* Exception table entry, emitted by EX_TABLE_ENTRY. */
+struct ex_table_entry
+  {
+    uintptr_t insn;             /* Instruction that may fault. */
+    uintptr_t fixup;            /* Where to resume if it does. */
+  };
+
+/* Exception table bounds, defined by kernel.lds.S. */
+extern const struct ex_table_entry _start_ex_table[], _end_ex_table[];
+
 static void kill (struct intr_frame *);
 static void page_fault (struct intr_frame *);
+static void device_not_available (struct intr_frame *);
+static uintptr_t search_ex_table (uintptr_t eip);
 
 /* Registers handlers for interrupts that can be caused by user
    programs.
@@ -47,7 +63,7 @@ exception_init (void)
   intr_register_int (0, 0, INTR_ON, kill, "#DE Divide Error");
   intr_register_int (1, 0, INTR_ON, kill, "#DB Debug Exception");
   intr_register_int (6, 0, INTR_ON, kill, "#UD Invalid Opcode Exception");
-  intr_register_int (7, 0, INTR_ON, kill,
+  intr_register_int (7, 0, INTR_ON, device_not_available,
                      "#NM Device Not Available Exception");
   intr_register_int (11, 0, INTR_ON, kill, "#NP Segment Not Present");
   intr_register_int (12, 0, INTR_ON, kill, "#SS Stack Fault Exception");
@@ -110,6 +126,15 @@ kill (struct intr_frame *f)
     }
 }
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - CR0.TS가 켜진 상태에서 FPU/SSE 명령 실행
+// 유저 스레드면 FPU 상태를 바꿔 끼우고 같은 명령을 다시 실행
+static void
+device_not_available (struct intr_frame *f)
+{
+  if (f->cs != SEL_UCSEG || !fpu_fault ())
+    kill (f);
+}
+
 /* Page fault handler.  This is a skeleton that must be filled in
    to implement virtual memory.  Some solutions to project 2 may
    also require modifying this code.
@@ -144,12 +169,41 @@ page_fault (struct intr_frame *f)
 
   /* Count page faults. */
   page_fault_cnt++;
+  thread_current ()->ru.page_faults++;  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 프로세스별 (getrusage)
 
   /* Determine cause. */
   not_present = (f->error_code & PF_P) == 0;
   write = (f->error_code & PF_W) != 0;
   user = (f->error_code & PF_U) != 0;
 
+#ifdef VM
+   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ 아직 안 올라온 페이지면 보조 페이지 테이블을 보고 채워 넣고 다시 실행
+   // (커널이 유저 버퍼에 접근하다 난 fault도 마찬가지)
+   // 없는 페이지라도 스택 근처면 스택을 늘림, 커널에서 난 fault는 syscall에 들어올 때의 esp로 판단
+   if (not_present && is_user_vaddr(fault_addr)
+       && (page_in(fault_addr, write)
+           || page_grow_stack(fault_addr, user ? f->esp : thread_current()->user_esp)))
+      return;
+   // fork()로 공유 중이라 읽기 전용으로 매핑된 페이지에 쓰기 -> 복사하고 다시 실행
+   if (!not_present && write && is_user_vaddr(fault_addr)
+       && page_copy_on_write(fault_addr))
+      return;
+#endif
+
+   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ 커널이 get_user()/put_user()로 유저 주소에 접근하다 fault
+   // -> 예외 테이블에 있는 명령어면 복구 주소로 점프하고, eax = -1로 실패를 알려줌
+   // 다른 곳에서 유저 주소를 건드리다 난 fault는 이어서 실행할 곳이 없으니 프로세스 종료
+   if (!user && is_user_vaddr(fault_addr)) {
+      uintptr_t fixup = search_ex_table((uintptr_t) f->eip);
+      if (fixup != 0) {
+         f->eip = (void (*) (void)) fixup;
+         f->eax = 0xffffffff;
+         return;
+      }
+      if (thread_current()->pagedir != NULL)
+         exit(-1);
+   }
+
    // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ 유저 영역 접근에서 kernel addr 접근 or unmapped 접근
    // -> exit(-1)을 호출해서 kill하지 않고 정상적으로 프로세스 종료
    if (user && (!is_user_vaddr(fault_addr) || not_present)) {
@@ -167,3 +221,14 @@ page_fault (struct intr_frame *f)
   kill (f);
 }
 
+// 예외 테이블에서 EIP에 있는 명령어의 복구 주소를 찾음, 없으면 0
+static uintptr_t
+search_ex_table (uintptr_t eip)
+{
+  const struct ex_table_entry *e;
+
+  for (e = _start_ex_table; e < _end_ex_table; e++)
+    if (e->insn == eip)
+      return e->fixup;
+  return 0;
+}
@@ -6,6 +6,14 @@
 #define PF_W 0x2    /* 0: read, 1: write. */
 #define PF_U 0x4    /* 0: kernel, 1: user process. */
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 주소에서 fault가 날 수 있는 커널 명령어를 예외 테이블에 등록
+// inline asm 안에서 INSN(fault가 날 명령어)과 FIXUP(복구 주소) 라벨을 적으면
+// page_fault()가 그 명령어에서 난 fault만 FIXUP으로 점프시키고 eax = -1
+#define EX_TABLE_ENTRY(INSN, FIXUP)             \
+  ".pushsection __ex_table, \"a\"\n"            \
+  ".long " INSN ", " FIXUP "\n"                 \
+  ".popsection\n"
+
 void exception_init (void);
 void exception_print_stats (void);
 
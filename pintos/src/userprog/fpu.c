@@ -0,0 +1,194 @@
+#include "userprog/fpu.h"
+#include <debug.h>
+#include <round.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/interrupt.h"
+#include "threads/malloc.h"
+#include "threads/thread.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 커널은 -msoft-float라 FPU를 안 씀 -> FPU 레지스터는 항상 마지막으로 FPU를 쓴 유저 스레드(fpu_owner)의 것
+// 다른 스레드로 바뀌면 CR0.TS를 켜 둠 -> 그 스레드가 FPU를 처음 건드릴 때 #NM이 나고,
+// 그때서야 fpu_owner의 상태를 FXSAVE로 저장하고 자기 상태를 FXRSTOR로 불러옴
+// (FPU를 안 쓰는 프로그램은 저장/복원 비용이 전혀 없음)
+
+/* CR0 and CR4 bits.  See [IA32-v3a] 2.5 "Control Registers". */
+#define CR0_MP 0x00000002       /* Monitor coprocessor. */
+#define CR0_EM 0x00000004       /* (Floating-point) Emulation. */
+#define CR0_TS 0x00000008       /* Task Switched. */
+#define CR0_NE 0x00000020       /* Numeric Error (#MF instead of IRQ13). */
+#define CR4_OSFXSR 0x00000200   /* OS supports FXSAVE/FXRSTOR and SSE. */
+#define CR4_OSXMMEXCPT 0x00000400 /* OS handles #XF. */
+
+/* CPUID leaf 1 EDX feature bits. */
+#define CPUID_FPU (1 << 0)      /* x87 FPU on chip. */
+#define CPUID_FXSR (1 << 24)    /* FXSAVE/FXRSTOR. */
+#define CPUID_SSE (1 << 25)     /* SSE. */
+
+/* FXSAVE area.  See [IA32-v2a] "FXSAVE". */
+#define FXSAVE_SIZE 512
+#define FXSAVE_ALIGN 16
+
+static bool fpu_enabled;          /* 하드웨어 FPU를 유저에게 허용했나. */
+static struct thread *fpu_owner;  /* FPU 레지스터에 상태가 올라가 있는 스레드. */
+
+/* 처음 FPU를 쓰는 스레드의 상태 (FNINIT 직후와 같음, XMM은 0). */
+static uint8_t fpu_initial[FXSAVE_SIZE] __attribute__ ((aligned (FXSAVE_ALIGN)));
+
+static inline uint32_t
+read_cr0 (void)
+{
+  uint32_t cr0;
+  asm volatile ("movl %%cr0, %0" : "=r" (cr0));
+  return cr0;
+}
+
+static inline void
+write_cr0 (uint32_t cr0)
+{
+  asm volatile ("movl %0, %%cr0" : : "r" (cr0) : "memory");
+}
+
+// CR0.TS 켜기 -> 다음 FPU 명령에서 #NM
+static inline void
+stts (void)
+{
+  write_cr0 (read_cr0 () | CR0_TS);
+}
+
+static inline void
+clts (void)
+{
+  asm volatile ("clts" : : : "memory");
+}
+
+// T의 FXSAVE 영역 (malloc()은 16바이트 정렬을 안 해줘서 직접 맞춤)
+static void *
+fpu_area (struct thread *t)
+{
+  return (void *) ROUND_UP ((uintptr_t) t->fpu, FXSAVE_ALIGN);
+}
+
+/* Enables the FPU for user processes if the CPU has FXSAVE.
+   Otherwise CR0.EM stays set and any floating-point instruction
+   in a user process kills it with #NM, as before. */
+void
+fpu_init (void)
+{
+  uint32_t eax = 1, ebx, ecx, edx;
+  uint32_t cr4;
+
+  asm volatile ("cpuid" : "+a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx));
+  if ((edx & (CPUID_FPU | CPUID_FXSR)) != (CPUID_FPU | CPUID_FXSR))
+    {
+      printf ("fpu: no FXSAVE support, floating point disabled\n");
+      return;
+    }
+
+  if (edx & CPUID_SSE)
+    {
+      asm volatile ("movl %%cr4, %0" : "=r" (cr4));
+      cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+      asm volatile ("movl %0, %%cr4" : : "r" (cr4));
+    }
+
+  /* Default control words: all exceptions masked, round to
+     nearest, extended precision, empty register stack. */
+  *(uint16_t *) &fpu_initial[0] = 0x037f;    /* FCW. */
+  *(uint32_t *) &fpu_initial[24] = 0x1f80;   /* MXCSR. */
+
+  write_cr0 ((read_cr0 () & ~CR0_EM) | CR0_MP | CR0_NE | CR0_TS);
+  fpu_enabled = true;
+}
+
+// 문맥 전환마다 process_activate()에서 호출 (인터럽트 꺼진 상태)
+// 레지스터가 이미 내 상태면 TS를 끄고, 아니면 켜서 처음 쓸 때 #NM이 나게 함
+void
+fpu_activate (void)
+{
+  if (!fpu_enabled)
+    return;
+  if (fpu_owner == thread_current ())
+    clts ();
+  else
+    stts ();
+}
+
+/* Handles #NM in a user process: saves the previous owner's FPU
+   state, then loads the current thread's, allocating it on first
+   use.  Returns false if the process must be killed instead. */
+bool
+fpu_fault (void)
+{
+  struct thread *cur = thread_current ();
+  enum intr_level old_level;
+
+  if (!fpu_enabled)
+    return false;
+
+  if (cur->fpu == NULL)
+    {
+      cur->fpu = malloc (FXSAVE_SIZE + FXSAVE_ALIGN - 1);
+      if (cur->fpu == NULL)
+        return false;
+      memcpy (fpu_area (cur), fpu_initial, FXSAVE_SIZE);
+    }
+
+  // 저장/복원 중에 선점되면 fpu_owner와 실제 레지스터가 어긋남
+  old_level = intr_disable ();
+  clts ();
+  if (fpu_owner != cur)
+    {
+      if (fpu_owner != NULL)
+        asm volatile ("fxsave %0" : "=m" (*(uint8_t (*)[FXSAVE_SIZE]) fpu_area (fpu_owner)));
+      asm volatile ("fxrstor %0" : : "m" (*(uint8_t (*)[FXSAVE_SIZE]) fpu_area (cur)));
+      fpu_owner = cur;
+    }
+  intr_set_level (old_level);
+  return true;
+}
+
+/* Gives the current thread a copy of thread FROM's FPU state,
+   for fork().  Returns false if memory allocation fails. */
+bool
+fpu_copy (struct thread *from)
+{
+  struct thread *cur = thread_current ();
+  enum intr_level old_level;
+
+  if (from->fpu == NULL)
+    return true;
+  cur->fpu = malloc (FXSAVE_SIZE + FXSAVE_ALIGN - 1);
+  if (cur->fpu == NULL)
+    return false;
+
+  // FROM의 최신 상태가 아직 레지스터에만 있으면 먼저 저장 (레지스터는 그대로 FROM 것)
+  old_level = intr_disable ();
+  if (fpu_owner == from)
+    {
+      clts ();
+      asm volatile ("fxsave %0" : "=m" (*(uint8_t (*)[FXSAVE_SIZE]) fpu_area (from)));
+      stts ();
+    }
+  memcpy (fpu_area (cur), fpu_area (from), FXSAVE_SIZE);
+  intr_set_level (old_level);
+  return true;
+}
+
+// thread_exit()에서 호출, 죽는 스레드의 상태는 저장할 필요 없음
+void
+fpu_exit (void)
+{
+  struct thread *cur = thread_current ();
+  enum intr_level old_level;
+
+  old_level = intr_disable ();
+  if (fpu_owner == cur)
+    fpu_owner = NULL;
+  intr_set_level (old_level);
+
+  free (cur->fpu);
+  cur->fpu = NULL;
+}
@@ -0,0 +1,15 @@
+#ifndef USERPROG_FPU_H
+#define USERPROG_FPU_H
+
+#include <stdbool.h>
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 프로세스의 하드웨어 FPU/SSE (lazy context switch)
+void fpu_init (void);
+void fpu_activate (void);
+bool fpu_fault (void);
+void fpu_exit (void);
+
+struct thread;
+bool fpu_copy (struct thread *from);
+
+#endif /* userprog/fpu.h */
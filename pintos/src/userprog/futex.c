@@ -0,0 +1,216 @@
+#include "userprog/futex.h"
+#include <debug.h>
+#include <hash.h>
+#include <list.h>
+#include <stdint.h>
+#include "threads/malloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/pagedir.h"
+#include "userprog/syscall.h"
+#ifdef VM
+#include "vm/page.h"
+#endif
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 같은 주소에서 기다리는 스레드들의 큐, 유저 주소가 아니라 (페이지, 페이지 안 오프셋)으로 찾음
+// -> 공유 메모리를 서로 다른 주소에 attach한 프로세스끼리도 같은 큐
+struct futex_key
+  {
+    const void *page;           /* 프레임의 커널 주소 또는 struct page. */
+    uintptr_t ofs;              /* 페이지 안 오프셋. */
+  };
+
+struct futex_queue
+  {
+    struct futex_key key;       /* 기다리는 int를 가리키는 키 (futex_key()). */
+    struct list waiters;        /* struct futex_waiter 리스트. */
+    struct hash_elem elem;      /* futex_queues 요소. */
+  };
+
+// FUTEX_WAIT 중인 스레드 하나 (스택에 있음), 그 스레드의 futex_waiter가 가리킴
+struct futex_waiter
+  {
+    struct semaphore sema;
+    struct thread *thread;      /* 기다리는 스레드. */
+    struct futex_queue *queue;  /* 들어있는 큐. */
+    bool cancelled;             /* futex_cancel()이 깨웠음. */
+    struct list_elem elem;
+  };
+
+static struct hash futex_queues;  /* 기다리는 스레드가 있는 큐만. */
+static struct lock futex_lock;    /* futex_queues와 큐들 보호. */
+
+static hash_hash_func futex_hash;
+static hash_less_func futex_less;
+static bool futex_key (int *uaddr, struct futex_key *);
+static struct futex_queue *find_queue (const struct futex_key *);
+static bool remove_waiter (struct futex_waiter *);
+
+void
+futex_init (void)
+{
+  if (!hash_init (&futex_queues, futex_hash, futex_less, NULL))
+    PANIC ("futex_init: out of memory");
+  lock_init (&futex_lock);
+}
+
+// FUTEX_WAIT: *UADDR가 아직 VAL이면 FUTEX_WAKE가 올 때까지 잠듦, 깨어나면 0
+//             값이 이미 바뀌었거나 프로세스가 종료 중이면 바로 -1
+//             기다리는 중에 프로세스가 종료하면 futex_cancel()이 깨워서 -1
+// FUTEX_WAKE: UADDR에서 기다리는 스레드를 최대 VAL개 깨우고 깨운 개수 반환
+// UADDR가 정렬 안 됐거나 매핑 안 된 주소, 모르는 OP면 -1
+int
+futex (int *uaddr, int op, int val)
+{
+  struct futex_key key;
+  struct futex_queue *q;
+  int woken = 0;
+
+  if (!futex_key (uaddr, &key))
+    return -1;
+
+  if (op == FUTEX_WAIT)
+    {
+      struct thread *cur = thread_current ();
+      struct futex_waiter w;
+
+      // 값 확인과 큐에 넣는 것을 futex_lock 안에서 같이 해야
+      // 그 사이에 값을 바꾸고 FUTEX_WAKE한 스레드의 알림을 놓치지 않음
+      int cur_val;
+
+      // exiting도 futex_lock 안에서 봐야 futex_cancel()과 엇갈리지 않음
+      lock_acquire (&futex_lock);
+      if (cur->leader->exiting
+          || !copy_from_user (&cur_val, uaddr, sizeof cur_val) || cur_val != val)
+        {
+          lock_release (&futex_lock);
+          return -1;
+        }
+      q = find_queue (&key);
+      if (q == NULL)
+        {
+          q = malloc (sizeof *q);
+          if (q == NULL)
+            {
+              lock_release (&futex_lock);
+              return -1;
+            }
+          q->key = key;
+          list_init (&q->waiters);
+          hash_insert (&futex_queues, &q->elem);
+        }
+      sema_init (&w.sema, 0);
+      w.thread = cur;
+      w.queue = q;
+      w.cancelled = false;
+      list_push_back (&q->waiters, &w.elem);
+      cur->futex_waiter = &w;
+      lock_release (&futex_lock);
+
+      sema_down (&w.sema);
+      return w.cancelled ? -1 : 0;
+    }
+  else if (op == FUTEX_WAKE)
+    {
+      lock_acquire (&futex_lock);
+      q = find_queue (&key);
+      if (q != NULL)
+        {
+          bool is_empty = false;
+          while (woken < val && !is_empty)
+            {
+              struct futex_waiter *w = list_entry (list_front (&q->waiters),
+                                                   struct futex_waiter, elem);
+              is_empty = remove_waiter (w);  // 마지막이면 Q도 해제됨
+              sema_up (&w->sema);
+              woken++;
+            }
+        }
+      lock_release (&futex_lock);
+      return woken;
+    }
+  return -1;
+}
+
+// 스레드 T가 FUTEX_WAIT 중이면 큐에서 빼고 깨움 (프로세스가 종료할 때, process_set_exiting())
+void
+futex_cancel (struct thread *t)
+{
+  struct futex_waiter *w;
+
+  lock_acquire (&futex_lock);
+  w = t->futex_waiter;
+  if (w != NULL)
+    {
+      remove_waiter (w);
+      w->cancelled = true;
+      sema_up (&w->sema);
+    }
+  lock_release (&futex_lock);
+}
+
+// W를 큐에서 빼고, 큐가 비면 큐도 해제하고 true (futex_lock)
+static bool
+remove_waiter (struct futex_waiter *w)
+{
+  struct futex_queue *q = w->queue;
+
+  list_remove (&w->elem);
+  w->thread->futex_waiter = NULL;
+  if (!list_empty (&q->waiters))
+    return false;
+  hash_delete (&futex_queues, &q->elem);
+  free (q);
+  return true;
+}
+
+// 유저 주소 UADDR의 int를 가리키는 키를 KEY에 채움, 매핑 안 된 주소면 false
+// 공유 메모리는 프레임의 커널 주소 (다른 주소에 attach한 프로세스끼리도 같음)
+// VM의 보조 페이지 테이블 페이지는 프레임이 스왑되면서 바뀌니까 struct page 주소로 (vm/page.c)
+// struct page는 malloc한 작은 블록이라 주소에 오프셋을 더하면 이웃 페이지와 겹칠 수 있음 -> 따로 둠
+static bool
+futex_key (int *uaddr, struct futex_key *key)
+{
+  if ((uintptr_t) uaddr % sizeof *uaddr != 0 || !is_user_vaddr (uaddr))
+    return false;
+  key->ofs = pg_ofs (uaddr);
+#ifdef VM
+  key->page = page_futex_key (uaddr);
+  if (key->page != NULL)
+    return true;
+#endif
+  key->page = pagedir_get_page (thread_current ()->pagedir, pg_round_down (uaddr));
+  return key->page != NULL;
+}
+
+static struct futex_queue *
+find_queue (const struct futex_key *key)
+{
+  struct futex_queue q;
+  struct hash_elem *e;
+
+  q.key = *key;
+  e = hash_find (&futex_queues, &q.elem);
+  return e != NULL ? hash_entry (e, struct futex_queue, elem) : NULL;
+}
+
+static unsigned
+futex_hash (const struct hash_elem *e, void *aux UNUSED)
+{
+  const struct futex_queue *q = hash_entry (e, struct futex_queue, elem);
+  return hash_bytes (&q->key, sizeof q->key);
+}
+
+static bool
+futex_less (const struct hash_elem *a, const struct hash_elem *b,
+            void *aux UNUSED)
+{
+  const struct futex_key *ka = &hash_entry (a, struct futex_queue, elem)->key;
+  const struct futex_key *kb = &hash_entry (b, struct futex_queue, elem)->key;
+
+  if (ka->page != kb->page)
+    return ka->page < kb->page;
+  return ka->ofs < kb->ofs;
+}
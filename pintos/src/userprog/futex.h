@@ -0,0 +1,13 @@
+#ifndef USERPROG_FUTEX_H
+#define USERPROG_FUTEX_H
+
+#include <futex.h>
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 공간 락을 위한 futex (wait / wake)
+struct thread;
+
+void futex_init (void);
+int futex (int *uaddr, int op, int val);
+void futex_cancel (struct thread *);
+
+#endif /* userprog/futex.h */
@@ -0,0 +1,232 @@
+#include "userprog/pipe.h"
+#include <debug.h>
+#include <poll.h>
+#include <string.h>
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/poll.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 버퍼 크기는 한 페이지 (palloc_get_page 한 번)
+#define PIPE_SIZE PGSIZE
+
+struct pipe
+  {
+    struct lock lock;           /* 아래 필드 전부 보호. */
+    struct condition readable;  /* 데이터가 생기거나 쓰는 쪽이 다 닫힘. */
+    struct condition writable;  /* 빈 공간이 생기거나 읽는 쪽이 다 닫힘. */
+    uint8_t *buf;               /* PIPE_SIZE 바이트 ring buffer. */
+    size_t head;                /* 다음에 읽을 위치. */
+    size_t used;                /* 버퍼에 들어있는 바이트 수. */
+    int readers;                /* 열려있는 읽는 쪽 fd 개수. */
+    int writers;                /* 열려있는 쓰는 쪽 fd 개수. */
+    struct list_elem elem;      /* all_pipes 요소. */
+  };
+
+// 살아있는 파이프 전부, 프로세스가 종료할 때 기다리는 스레드를 깨우려고 (pipe_wake_all())
+static struct list all_pipes;
+static struct lock all_pipes_lock;     /* all_pipes 보호, 파이프의 lock보다 먼저. */
+
+static bool is_exiting (void);
+
+void
+pipe_init (void)
+{
+  list_init (&all_pipes);
+  lock_init (&all_pipes_lock);
+}
+
+// 읽는 쪽 하나, 쓰는 쪽 하나가 열린 새 파이프, 메모리가 없으면 NULL
+struct pipe *
+pipe_create (void)
+{
+  struct pipe *p = malloc (sizeof *p);
+  if (p == NULL)
+    return NULL;
+  p->buf = palloc_get_page (0);
+  if (p->buf == NULL)
+    {
+      free (p);
+      return NULL;
+    }
+  lock_init (&p->lock);
+  cond_init (&p->readable);
+  cond_init (&p->writable);
+  p->head = p->used = 0;
+  p->readers = p->writers = 1;
+
+  lock_acquire (&all_pipes_lock);
+  list_push_back (&all_pipes, &p->elem);
+  lock_release (&all_pipes_lock);
+  return p;
+}
+
+// 최대 SIZE 바이트를 읽어서 BUFFER에 복사, 읽은 바이트 수 반환
+// 비어있으면 쓰는 쪽이 남아있는 동안 기다림, 쓰는 쪽이 다 닫혔으면 0 (EOF)
+// 기다리는 중에 프로세스가 종료하면 0
+// BUFFER는 커널 버퍼 (유저 버퍼와는 read()가 copy_to_user()로 주고받음)
+int
+pipe_read (struct pipe *p, void *buffer, size_t size)
+{
+  uint8_t *dst = buffer;
+  size_t n, chunk;
+
+  if (size == 0)
+    return 0;
+
+  lock_acquire (&p->lock);
+  while (p->used == 0 && p->writers > 0 && !is_exiting ())
+    cond_wait (&p->readable, &p->lock);
+
+  // ring buffer 끝에서 잘리면 두 번에 나눠서 복사
+  n = size < p->used ? size : p->used;
+  chunk = n < PIPE_SIZE - p->head ? n : PIPE_SIZE - p->head;
+  memcpy (dst, p->buf + p->head, chunk);
+  memcpy (dst + chunk, p->buf, n - chunk);
+  p->head = (p->head + n) % PIPE_SIZE;
+  p->used -= n;
+
+  if (n > 0)
+    cond_broadcast (&p->writable, &p->lock);
+  lock_release (&p->lock);
+  if (n > 0)
+    poll_notify ();
+  return n;
+}
+
+// BUFFER의 SIZE 바이트를 전부 쓸 때까지, 가득 차 있으면 기다림
+// 읽는 쪽이 다 닫히면 그때까지 쓴 바이트 수, 하나도 못 썼으면 -1
+// 기다리는 중에 프로세스가 종료해도 마찬가지
+int
+pipe_write (struct pipe *p, const void *buffer, size_t size)
+{
+  const uint8_t *src = buffer;
+  size_t written = 0;
+
+  lock_acquire (&p->lock);
+  while (written < size)
+    {
+      size_t tail, n, chunk;
+
+      while (p->used == PIPE_SIZE && p->readers > 0 && !is_exiting ())
+        cond_wait (&p->writable, &p->lock);
+      if (p->readers == 0 || p->used == PIPE_SIZE)
+        break;
+
+      tail = (p->head + p->used) % PIPE_SIZE;
+      n = size - written;
+      if (n > PIPE_SIZE - p->used)
+        n = PIPE_SIZE - p->used;
+      chunk = n < PIPE_SIZE - tail ? n : PIPE_SIZE - tail;
+      memcpy (p->buf + tail, src + written, chunk);
+      memcpy (p->buf, src + written + chunk, n - chunk);
+      p->used += n;
+      written += n;
+
+      cond_broadcast (&p->readable, &p->lock);
+    }
+  lock_release (&p->lock);
+  if (written > 0)
+    poll_notify ();
+
+  return written > 0 || size == 0 ? (int) written : -1;
+}
+
+// poll()용: 지금 막히지 않고 할 수 있는 것 (POLLIN, POLLOUT, POLLHUP, POLLERR)
+int
+pipe_poll (struct pipe *p, bool writer)
+{
+  int events = 0;
+
+  lock_acquire (&p->lock);
+  if (writer)
+    {
+      if (p->readers == 0)
+        events |= POLLERR;
+      else if (p->used < PIPE_SIZE)
+        events |= POLLOUT;
+    }
+  else
+    {
+      if (p->used > 0)
+        events |= POLLIN;
+      if (p->writers == 0)
+        events |= POLLHUP;
+    }
+  lock_release (&p->lock);
+  return events;
+}
+
+// 자식 프로세스가 fd를 물려받을 때, WRITER면 쓰는 쪽 아니면 읽는 쪽 개수 증가
+void
+pipe_dup (struct pipe *p, bool writer)
+{
+  lock_acquire (&p->lock);
+  if (writer)
+    p->writers++;
+  else
+    p->readers++;
+  lock_release (&p->lock);
+}
+
+// 한쪽 fd를 닫음, 기다리던 반대쪽을 깨워주고 양쪽 다 닫혔으면 해제
+void
+pipe_close (struct pipe *p, bool writer)
+{
+  bool is_last;
+
+  lock_acquire (&p->lock);
+  if (writer)
+    {
+      ASSERT (p->writers > 0);
+      if (--p->writers == 0)
+        cond_broadcast (&p->readable, &p->lock);
+    }
+  else
+    {
+      ASSERT (p->readers > 0);
+      if (--p->readers == 0)
+        cond_broadcast (&p->writable, &p->lock);
+    }
+  is_last = p->readers == 0 && p->writers == 0;
+  lock_release (&p->lock);
+  poll_notify ();  // 반대쪽에서 poll() 중이면 POLLHUP/POLLERR
+
+  if (is_last)
+    {
+      lock_acquire (&all_pipes_lock);
+      list_remove (&p->elem);
+      lock_release (&all_pipes_lock);
+      palloc_free_page (p->buf);
+      free (p);
+    }
+}
+
+// 파이프에서 기다리는 스레드를 전부 깨움 -> 종료 중인 프로세스의 스레드는 기다리다 말고 리턴
+// 다른 스레드는 다시 확인하고 또 기다림 (process_set_exiting()에서 호출)
+void
+pipe_wake_all (void)
+{
+  struct list_elem *e;
+
+  lock_acquire (&all_pipes_lock);
+  for (e = list_begin (&all_pipes); e != list_end (&all_pipes); e = list_next (e))
+    {
+      struct pipe *p = list_entry (e, struct pipe, elem);
+      lock_acquire (&p->lock);
+      cond_broadcast (&p->readable, &p->lock);
+      cond_broadcast (&p->writable, &p->lock);
+      lock_release (&p->lock);
+    }
+  lock_release (&all_pipes_lock);
+}
+
+// 현재 스레드의 프로세스가 종료 중이라 더 기다리면 안 되나
+static bool
+is_exiting (void)
+{
+  return thread_current ()->leader->exiting;
+}
@@ -0,0 +1,20 @@
+#ifndef USERPROG_PIPE_H
+#define USERPROG_PIPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 익명 파이프 (pipe() 시스템 콜)
+// 커널 안의 한 페이지짜리 ring buffer, 읽는 쪽/쓰는 쪽 fd 개수로 수명 관리
+struct pipe;
+
+void pipe_init (void);
+struct pipe *pipe_create (void);
+int pipe_read (struct pipe *, void *buffer, size_t size);
+int pipe_write (struct pipe *, const void *buffer, size_t size);
+int pipe_poll (struct pipe *, bool writer);
+void pipe_dup (struct pipe *, bool writer);
+void pipe_close (struct pipe *, bool writer);
+void pipe_wake_all (void);
+
+#endif /* userprog/pipe.h */
@@ -0,0 +1,76 @@
+#include "userprog/poll.h"
+#include <debug.h>
+#include "devices/timer.h"
+#include "threads/interrupt.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// poll() 중인 스레드들, 인터럽트 핸들러(input_putc, timer)에서도 보니까 인터럽트 끄고 접근
+static struct list pollers = LIST_INITIALIZER (pollers);
+
+// W를 등록, TIMEOUT_TICKS가 음수면 무한히, 0이면 바로 timeout
+// fd를 확인하기 "전에" 등록해야 확인과 잠드는 사이에 온 알림을 놓치지 않음
+void
+poll_register (struct poll_waiter *w, int64_t timeout_ticks)
+{
+  enum intr_level old_level;
+
+  sema_init (&w->sema, 0);
+  w->deadline = timeout_ticks < 0 ? -1 : timer_ticks () + timeout_ticks;
+  w->expired = timeout_ticks == 0;
+
+  old_level = intr_disable ();
+  list_push_back (&pollers, &w->elem);
+  intr_set_level (old_level);
+}
+
+void
+poll_unregister (struct poll_waiter *w)
+{
+  enum intr_level old_level = intr_disable ();
+  list_remove (&w->elem);
+  intr_set_level (old_level);
+}
+
+bool
+poll_expired (const struct poll_waiter *w)
+{
+  return w->expired;
+}
+
+// 알림이나 timeout이 올 때까지 잠듦 (등록 이후에 온 알림이면 바로 리턴)
+void
+poll_wait (struct poll_waiter *w)
+{
+  sema_down (&w->sema);
+}
+
+// 어떤 fd가 준비됐을 수도 있음 -> 기다리는 스레드 전부 깨움
+// 인터럽트 핸들러에서 불러도 됨
+void
+poll_notify (void)
+{
+  enum intr_level old_level = intr_disable ();
+  struct list_elem *e;
+
+  for (e = list_begin (&pollers); e != list_end (&pollers); e = list_next (e))
+    sema_up (&list_entry (e, struct poll_waiter, elem)->sema);
+  intr_set_level (old_level);
+}
+
+// 타이머 인터럽트마다 호출, timeout이 지난 스레드를 한 번씩 깨움
+void
+poll_tick (int64_t now)
+{
+  struct list_elem *e;
+
+  ASSERT (intr_get_level () == INTR_OFF);
+  for (e = list_begin (&pollers); e != list_end (&pollers); e = list_next (e))
+    {
+      struct poll_waiter *w = list_entry (e, struct poll_waiter, elem);
+      if (!w->expired && w->deadline >= 0 && w->deadline <= now)
+        {
+          w->expired = true;
+          sema_up (&w->sema);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef USERPROG_POLL_H
+#define USERPROG_POLL_H
+
+#include <list.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "threads/synch.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - poll()에서 기다리는 스레드
+// fd 상태가 바뀔 수 있는 곳(콘솔 입력, 파이프)은 poll_notify()로 전부 깨우고
+// 깨어난 쪽이 fd를 다시 확인함
+struct poll_waiter
+  {
+    struct semaphore sema;      /* poll_notify(), poll_tick()이 up. */
+    int64_t deadline;           /* 이 tick이 되면 timeout (-1이면 무한). */
+    bool expired;               /* timeout 지났음. */
+    struct list_elem elem;      /* pollers 요소. */
+  };
+
+void poll_register (struct poll_waiter *, int64_t timeout_ticks);
+void poll_unregister (struct poll_waiter *);
+bool poll_expired (const struct poll_waiter *);
+void poll_wait (struct poll_waiter *);
+void poll_notify (void);
+void poll_tick (int64_t now);
+
+#endif /* userprog/poll.h */
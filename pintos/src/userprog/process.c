@@ -5,22 +5,57 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <vtime.h>
+#include "userprog/elf-cache.h"
+#include "userprog/fpu.h"
+#include "userprog/futex.h"
 #include "userprog/gdt.h"
 #include "userprog/pagedir.h"
+#include "userprog/pipe.h"
+#include "userprog/poll.h"
 #include "userprog/tss.h"
+#include "userprog/shm.h"
+#include "userprog/syscall.h"
 #include "filesys/directory.h"
 #include "filesys/file.h"
 #include "filesys/filesys.h"
 #include "threads/flags.h"
 #include "threads/init.h"
 #include "threads/interrupt.h"
+#include "threads/malloc.h"
 #include "threads/palloc.h"
+#include "threads/synch.h"
 #include "threads/thread.h"
 #include "threads/vaddr.h"
 #include "devices/timer.h"
+#ifdef VM
+#include "vm/mmap.h"
+#include "vm/page.h"
+#endif
 
 static thread_func start_process NO_RETURN;
 static bool load (const char *cmdline, void (**eip) (void), void **esp);
+static int reap_child (struct thread *child);
+static void release_child (struct thread *child);
+static void rusage_add (struct rusage *dst, const struct rusage *src);
+static thread_func uthread_start NO_RETURN;
+static void uthread_wait_all (void);
+static void uthread_finish (void);
+static bool uthread_alloc_stack (struct thread *leader, int slot);
+static void uthread_free_stack (struct thread *leader, int slot);
+
+// process_set_exiting()이 thread_foreach()로 프로세스의 스레드를 모을 때
+struct wake_info
+  {
+    struct thread *leader;      /* 종료하는 프로세스. */
+    struct thread **threads;    /* 모은 스레드들. */
+    int cnt;                    /* 모은 개수. */
+  };
+
+static thread_action_func wake_joiner;
+#ifdef VM
+static thread_func fork_start NO_RETURN;
+#endif
 
 /* Starts a new thread running a user program loaded from
    FILENAME.  The new thread may be scheduled (and may even exit)
@@ -82,6 +117,8 @@ start_process (void *file_name_)
   sema_up(&thread_current()->s_load);
 
   if(success) {
+    syscall_stats_start();  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - -strace 대상이면 통계 시작
+
     int argc = 0;
     char *argv[32];
 
@@ -130,8 +167,10 @@ start_process (void *file_name_)
 
   /* If load failed, quit. */
   palloc_free_page (file_name);
-  if (!success) 
+  if (!success) {
+    thread_current()->is_exit = -1;  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - spawn()한 부모는 wait()에서 -1을 받음
     thread_exit ();
+  }
 
   /* Start the user process by simulating a return from an
      interrupt, implemented by intr_exit (in
@@ -156,17 +195,433 @@ int
 process_wait (tid_t child_tid UNUSED) 
 {
   struct thread *child = get_child(child_tid);
-  if (child == NULL) return -1;       // 자식이 아닌 경우
-  if (child->is_wait) return -1;      // 이미 wait()한 경우
+  if (child == NULL) return -1;       // 자식이 아니거나 이미 wait()한 경우 (child_list에서 빠짐)
   
-  child->is_wait = true;              // 중복 방지 플래그 설정
   sema_down(&child->s_wait);          // 자식이 죽을 때까지 대기
+  return reap_child(child);
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// CHILD_TID가 -1이면 아무 자식이나, 아니면 그 자식이 종료할 때까지 대기
+// NOHANG이면 기다리지 않고, 아직 종료한 자식이 없으면 0 리턴
+// 회수한 자식의 tid를 리턴하고 종료 코드는 *STATUS에 저장, 기다릴 자식이 없으면 TID_ERROR
+// 아무 자식이나 기다릴 때는 exited_list 맨 앞에서 꺼내니까 자식 수와 상관없이 O(1)
+tid_t
+process_waitpid (tid_t child_tid, int *status, bool nohang)
+{
+  struct thread *cur = thread_current();
+  struct thread *child;
+  enum intr_level old_level;
+  tid_t tid;
+
+  if (child_tid != -1) {
+    child = get_child(child_tid);
+    if (child == NULL) return TID_ERROR;
+    if (nohang) {
+      if (!sema_try_down(&child->s_wait)) return 0;
+    }
+    else
+      sema_down(&child->s_wait);
+  }
+  else {
+    for (;;) {
+      bool has_child;
+
+      old_level = intr_disable();
+      if (!list_empty(&cur->exited_list)) {
+        child = list_entry(list_front(&cur->exited_list), struct thread, exit_elem);
+        intr_set_level(old_level);
+        break;
+      }
+      has_child = !list_empty(&cur->child_list);
+      intr_set_level(old_level);
+
+      if (!has_child) return TID_ERROR;
+      if (nohang) return 0;
+      sema_down(&cur->s_child_exit);  // 누군가 종료하면 깨어나서 다시 확인
+    }
+    sema_down(&child->s_wait);  // exited_list에 있으면 이미 up 돼있어서 바로 통과
+  }
 
+  tid = child->tid;
+  *status = reap_child(child);
+  return tid;
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 종료한 자식 CHILD를 회수
+// 종료 코드를 리턴하고, 자원 사용량을 합산한 뒤 리스트에서 빼고 해제
+static int
+reap_child (struct thread *child)
+{
+  struct thread *cur = thread_current();
+  enum intr_level old_level;
   int status = child->is_exit;        // 자식의 종료코드 획득
+
+  rusage_add(&cur->ru_children, &child->ru);           // 자식의 자원 사용량을 부모에 합산
+  rusage_add(&cur->ru_children, &child->ru_children);  // 손자들 것까지
+
+  old_level = intr_disable();
   list_remove(&child->child);         // child_list에서 제거
+  list_remove(&child->exit_elem);     // exited_list에서 제거
+  intr_set_level(old_level);
+
+  release_child(child);
   return status;
 }
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 자식의 struct thread는 부모가 다 읽은 뒤에만 해제해야 함
+// 자식이 이미 죽었으면(DYING) 여기서 해제하고, 아직 안 죽었으면 is_wait를 세워서
+// thread_schedule_tail()에서 해제하게 함 (인터럽트 끄고 판단해야 둘이 엇갈리지 않음)
+static void
+release_child (struct thread *child)
+{
+  enum intr_level old_level = intr_disable();
+  bool is_dead = child->status == THREAD_DYING;
+  if (!is_dead)
+    child->is_wait = true;
+  intr_set_level(old_level);
+
+  if (is_dead)
+    palloc_free_page(child);
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 자원 사용량 SRC를 DST에 더함
+static void
+rusage_add (struct rusage *dst, const struct rusage *src)
+{
+  dst->user_ticks += src->user_ticks;
+  dst->kernel_ticks += src->kernel_ticks;
+  dst->nvcsw += src->nvcsw;
+  dst->nivcsw += src->nivcsw;
+  dst->page_faults += src->page_faults;
+  dst->sectors_read += src->sectors_read;
+  dst->sectors_written += src->sectors_written;
+  dst->bytes_read += src->bytes_read;
+  dst->bytes_written += src->bytes_written;
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 스레드 만들 때 uthread_start()에 넘겨주는 정보 (만드는 스레드의 스택에 있음)
+struct uthread_start_info
+  {
+    struct thread *leader;      /* 프로세스의 첫 스레드. */
+    void *entry;                /* 유저 모드 시작 주소 (lib/user의 trampoline). */
+    void *esp;                  /* 유저 스택. */
+    int slot;                   /* 스택 자리. */
+    struct semaphore started;   /* 새 스레드가 정보를 다 읽으면 up. */
+  };
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 현재 프로세스에 유저 스레드를 하나 더 만들고 tid 반환 (실패하면 TID_ERROR)
+// 새 스레드는 자기 스택에 [가짜 리턴 주소][FN][ARG]를 놓고 ENTRY에서 시작
+// -> ENTRY(FN, ARG)를 부른 것처럼 보임
+tid_t
+uthread_create (void *entry, void *fn, void *arg)
+{
+  struct thread *leader = thread_current ()->leader;
+  struct uthread_start_info info;
+  enum intr_level old_level;
+  uint32_t top[3];
+  tid_t tid;
+  int slot;
+
+  if (entry == NULL || !is_user_vaddr (entry))
+    return TID_ERROR;
+
+  // 빈 스택 자리 하나 잡음
+  old_level = intr_disable ();
+  for (slot = 0; slot < UTHREAD_MAX; slot++)
+    if ((leader->uthread_stacks & (1u << slot)) == 0)
+      break;
+  if (slot < UTHREAD_MAX)
+    leader->uthread_stacks |= 1u << slot;
+  intr_set_level (old_level);
+  if (slot == UTHREAD_MAX)
+    return TID_ERROR;
+
+  info.esp = UTHREAD_STACK_TOP (slot) - sizeof top;
+  top[0] = 0;
+  top[1] = (uint32_t) fn;
+  top[2] = (uint32_t) arg;
+  if (!uthread_alloc_stack (leader, slot))
+    {
+      old_level = intr_disable ();
+      leader->uthread_stacks &= ~(1u << slot);
+      intr_set_level (old_level);
+      return TID_ERROR;
+    }
+  if (!copy_to_user (info.esp, top, sizeof top))
+    {
+      uthread_free_stack (leader, slot);
+      return TID_ERROR;
+    }
+
+  info.leader = leader;
+  info.entry = entry;
+  info.slot = slot;
+  sema_init (&info.started, 0);
+
+  // 새 스레드가 바로 끝나도 leader가 기다리도록 먼저 셈
+  old_level = intr_disable ();
+  leader->uthread_cnt++;
+  intr_set_level (old_level);
+
+  tid = thread_create (leader->name, thread_get_priority (), uthread_start, &info);
+  if (tid == TID_ERROR)
+    {
+      old_level = intr_disable ();
+      leader->uthread_cnt--;
+      intr_set_level (old_level);
+      uthread_free_stack (leader, slot);
+      return TID_ERROR;
+    }
+  sema_down (&info.started);
+  return tid;
+}
+
+// 새 유저 스레드의 시작, thread_create()가 해준 자식 프로세스 설정은 되돌리고
+// leader의 page directory로 유저 모드에 들어감
+static void
+uthread_start (void *info_)
+{
+  struct uthread_start_info *info = info_;
+  struct thread *cur = thread_current ();
+  struct intr_frame if_;
+  enum intr_level old_level;
+
+  fd_close_all ();  // thread_create()가 복사해준 파이프 fd (아직 leader == 자기 자신)
+
+  old_level = intr_disable ();
+  list_remove (&cur->child);  // 만든 스레드의 자식 프로세스가 아님
+  cur->parent = NULL;
+  cur->leader = info->leader;
+  cur->pagedir = info->leader->pagedir;
+  cur->uthread_slot = info->slot;
+  list_push_back (&info->leader->uthread_list, &cur->uthread_elem);
+  intr_set_level (old_level);
+
+  memset (&if_, 0, sizeof if_);
+  if_.gs = if_.fs = if_.es = if_.ds = if_.ss = SEL_UDSEG;
+  if_.cs = SEL_UCSEG;
+  if_.eflags = FLAG_IF | FLAG_MBS;
+  if_.eip = info->entry;
+  if_.esp = info->esp;
+  sema_up (&info->started);  // 이 뒤로 INFO는 쓰면 안 됨
+
+  process_activate ();
+  process_check_exit ();
+  asm volatile ("movl %0, %%esp; jmp intr_exit" : : "g" (&if_) : "memory");
+  NOT_REACHED ();
+}
+
+// 같은 프로세스의 유저 스레드 TID가 끝날 때까지 기다림
+// 성공하면 0, 그런 스레드가 없거나 이미 join했거나 자기 자신이면 -1
+int
+uthread_join (tid_t tid)
+{
+  struct thread *cur = thread_current ();
+  struct thread *t = NULL;
+  enum intr_level old_level;
+  struct list_elem *e;
+  bool joined;
+
+  old_level = intr_disable ();
+  for (e = list_begin (&cur->leader->uthread_list);
+       e != list_end (&cur->leader->uthread_list); e = list_next (e))
+    if (list_entry (e, struct thread, uthread_elem)->tid == tid)
+      {
+        t = list_entry (e, struct thread, uthread_elem);
+        break;
+      }
+  if (t != NULL && t != cur)
+    {
+      list_remove (&t->uthread_elem);  // 두 번 join 못 하게 바로 뺌
+      t->joiner = cur;
+    }
+  intr_set_level (old_level);
+  if (t == NULL || t == cur)
+    return -1;
+
+  // T가 끝나면 uthread_finish()가, 프로세스가 종료하면 process_set_exiting()이 s_join을 up
+  old_level = intr_disable ();
+  while (!(joined = sema_try_down (&t->s_wait)) && !cur->leader->exiting)
+    sema_down (&cur->s_join);
+  t->joiner = NULL;
+  if (!joined)
+    {
+      // 종료 중이라 그만 기다림 -> T는 leader가 uthread_wait_all()에서 회수
+      list_push_back (&cur->leader->uthread_list, &t->uthread_elem);
+    }
+  intr_set_level (old_level);
+  if (!joined)
+    return -1;
+  release_child (t);
+  return 0;
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 프로세스를 종료 중으로 표시하고, 커널 안에서 기다리고 있는 같은 프로세스의 스레드를 전부 깨움
+// (FUTEX_WAIT, 파이프, poll(), 콘솔 read(), thread_join())
+// 깨어난 스레드는 exiting을 보고 기다리던 걸 그만두고, 유저 모드로 돌아가기 전에 종료 (process_check_exit())
+// 처음 표시한 거면 true (exit()가 여러 스레드에서 동시에 불려도 출력은 한 번)
+bool
+process_set_exiting (void)
+{
+  struct thread *leader = thread_current ()->leader;
+  struct thread *threads[UTHREAD_MAX + 1];
+  struct wake_info info;
+  enum intr_level old_level;
+  bool is_first;
+  int i;
+
+  info.leader = leader;
+  info.threads = threads;
+  info.cnt = 0;
+  old_level = intr_disable ();
+  is_first = !leader->exiting;
+  leader->exiting = true;
+  if (is_first)
+    thread_foreach (wake_joiner, &info);
+  intr_set_level (old_level);
+  if (!is_first)
+    return false;
+
+  // 스레드들은 leader가 uthread_wait_all()에서 다 끝날 때까지 해제하지 않음
+  for (i = 0; i < info.cnt; i++)
+    futex_cancel (threads[i]);
+  pipe_wake_all ();
+  poll_notify ();  // poll()과 콘솔 read()
+  return true;
+}
+
+// thread_foreach()에서 LEADER의 프로세스 스레드마다 호출 (인터럽트 꺼짐)
+// join 중이면 깨우고, futex를 깨울 수 있게 모아둠
+static void
+wake_joiner (struct thread *t, void *info_)
+{
+  struct wake_info *info = info_;
+
+  if (t->leader != info->leader || t->status == THREAD_DYING)
+    return;
+  sema_up (&t->s_join);
+  if (info->cnt < UTHREAD_MAX + 1)
+    info->threads[info->cnt++] = t;
+}
+
+// 프로세스가 종료 중이면 (다른 스레드가 exit()했으면) 유저 모드로 돌아가지 않고 종료
+// syscall과 외부 인터럽트에서 유저 모드로 돌아가기 직전에 호출
+void
+process_check_exit (void)
+{
+  if (thread_current ()->leader->exiting)
+    {
+      intr_enable ();  // 외부 인터럽트 끝에서 불렸으면 꺼져 있음
+      thread_exit ();
+    }
+}
+
+// (leader) 남은 유저 스레드가 전부 끝날 때까지 기다리고 해제
+// 커널 안에서 기다리던 스레드(ex. 아무도 안 깨우는 futex)는 process_set_exiting()이 깨움
+static void
+uthread_wait_all (void)
+{
+  struct thread *cur = thread_current ();
+  enum intr_level old_level;
+
+  process_set_exiting ();
+  old_level = intr_disable ();
+  while (cur->uthread_cnt > 0)
+    sema_down (&cur->s_uthread_exit);  // 인터럽트 꺼진 채로 잠들어도 됨
+  intr_set_level (old_level);
+
+  while (!list_empty (&cur->uthread_list))
+    {
+      struct thread *t = list_entry (list_pop_front (&cur->uthread_list),
+                                     struct thread, uthread_elem);
+      release_child (t);
+    }
+}
+
+// (유저 스레드) 자기 스택만 정리하고 leader에게 알림, 나머지는 leader 몫
+static void
+uthread_finish (void)
+{
+  struct thread *cur = thread_current ();
+  struct thread *leader = cur->leader;
+  enum intr_level old_level;
+
+  uthread_free_stack (leader, cur->uthread_slot);
+  rusage_add (&leader->ru, &cur->ru);
+
+  // leader가 page directory를 없애기 전에 여기서 벗어나야 함
+  cur->pagedir = NULL;
+  pagedir_activate (NULL);
+
+  old_level = intr_disable ();
+  leader->uthread_cnt--;
+  sema_up (&leader->s_uthread_exit);
+  sema_up (&cur->s_wait);
+  if (cur->joiner != NULL)
+    sema_up (&cur->joiner->s_join);  // join 중이면 깨워줌
+  intr_set_level (old_level);
+}
+
+// 스택 자리 SLOT의 맨 위 페이지를 만듦 (현재 프로세스의 것, 메모리가 모자라거나 이미 쓰는 주소면 false)
+// VM이면 보조 페이지 테이블의 0 페이지로 등록하고 바로 올림 -> 다른 페이지처럼 내보낼 수 있고
+// 아래쪽은 메인 스택처럼 fault가 나면 UTHREAD_STACK_SIZE까지 늘려줌 (vm/page.c)
+static bool
+uthread_alloc_stack (struct thread *leader UNUSED, int slot)
+{
+  uint8_t *upage = UTHREAD_STACK_TOP (slot) - PGSIZE;
+#ifdef VM
+  if (process_page_in_use (upage) || !page_add_zero (upage, true))
+    return false;
+  if (!page_in (upage, true))
+    {
+      page_remove (upage);
+      return false;
+    }
+  return true;
+#else
+  uint8_t *kpage = palloc_get_page (PAL_USER | PAL_ZERO);
+
+  if (kpage == NULL || process_page_in_use (upage)
+      || !pagedir_set_page (leader->pagedir, upage, kpage, true))
+    {
+      if (kpage != NULL)
+        palloc_free_page (kpage);
+      return false;
+    }
+  return true;
+#endif
+}
+
+// 스택 자리 SLOT의 페이지를 해제하고 자리를 비움
+// VM이면 늘어난 페이지까지 자리 전체를 보조 페이지 테이블에서 뺌, 아니면 스택은 한 페이지뿐
+static void
+uthread_free_stack (struct thread *leader, int slot)
+{
+  enum intr_level old_level;
+#ifdef VM
+  uint8_t *upage;
+
+  for (upage = UTHREAD_STACK_TOP (slot) - UTHREAD_STACK_SIZE;
+       upage < UTHREAD_STACK_TOP (slot); upage += PGSIZE)
+    page_remove (upage);
+#else
+  uint8_t *upage = UTHREAD_STACK_TOP (slot) - PGSIZE;
+  void *kpage = pagedir_get_page (leader->pagedir, upage);
+
+  if (kpage != NULL)
+    {
+      pagedir_clear_page (leader->pagedir, upage);
+      palloc_free_page (kpage);
+    }
+#endif
+  old_level = intr_disable ();
+  leader->uthread_stacks &= ~(1u << slot);
+  intr_set_level (old_level);
+}
+
 /* Free the current process's resources. */
 void
 process_exit (void)
@@ -174,10 +629,61 @@ process_exit (void)
   struct thread *cur = thread_current ();
   uint32_t *pd;
 
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 프로세스의 첫 스레드면 다른 유저 스레드가 다 끝날 때까지 기다림
+  if (cur->leader == cur)
+    uthread_wait_all();
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - -strace 대상이었다면 syscall 통계 출력
+  syscall_stats_done();
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - read()/write()가 쓰던 버퍼 해제
+  palloc_free_page(cur->io_buf);
+  cur->io_buf = NULL;
+
   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 자식 프로세스 종료를 기다리는 부모를 깨움
+  // 부모의 exited_list에 넣고 알려줌 (부모가 먼저 죽었으면 parent == NULL)
+  enum intr_level old_level = intr_disable();
   if (cur->parent != NULL) {
+    list_push_back(&cur->parent->exited_list, &cur->exit_elem);
+    sema_up(&cur->parent->s_child_exit);  // wait-any 중이면 깨워줌
     sema_up(&cur->s_wait);  // 부모가 wait() 중이면 깨워줌
   }
+  intr_set_level(old_level);
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 회수 안 한 자식들 정리
+  // 이미 죽은 자식은 아무도 안 읽으니까 바로 해제, 살아있는 자식은 고아로 만들고 죽을 때 해제
+  for (;;) {
+    struct thread *child;
+    bool is_dead;
+
+    old_level = intr_disable();
+    if (list_empty(&cur->child_list)) {
+      intr_set_level(old_level);
+      break;
+    }
+    child = list_entry(list_pop_front(&cur->child_list), struct thread, child);
+    child->parent = NULL;
+    is_dead = child->status == THREAD_DYING;
+    if (!is_dead)
+      child->is_wait = true;
+    intr_set_level(old_level);
+
+    if (is_dead)
+      palloc_free_page(child);
+  }
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 스레드는 여기까지, 아래(실행 파일, fd, page directory)는 프로세스 자원
+  if (cur->leader != cur) {
+    uthread_finish();
+    return;
+  }
+
+#ifdef VM
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - mmap 매핑의 고친 페이지를 파일에 쓰고 떼어냄
+  // 그리고 보조 페이지 테이블의 프레임 해제 (실행 파일을 닫기 전에)
+  mmap_exit();
+  page_table_destroy();
+#endif
 
   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 현재 실행중인 파일에 다시 쓰기가 가능하도록 바꿔줌
   if(cur->cur_file) {
@@ -186,6 +692,11 @@ process_exit (void)
     cur->cur_file = NULL;
   }
 
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 공유 메모리 매핑부터 떼어냄 (pagedir_destroy()가 공유 프레임을 해제하면 안 됨)
+  shm_exit();
+  if (cur->pagedir != NULL)
+    pagedir_clear_page(cur->pagedir, (void *) VTIME_ADDR);  // 시간 페이지도 (커널 정적 변수)
+
   /* Destroy the current process's page directory and switch back
      to the kernel-only page directory. */
   pd = cur->pagedir;
@@ -203,14 +714,21 @@ process_exit (void)
       pagedir_destroy (pd);
     }
   
-  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table에 있는 파일들 모두 닫아줌
-  int i;
-  for (i = 2; i < FD_MAX; i++) {
-    if (cur->fd_table[i]) {
-      file_close(cur->fd_table[i]);
-      cur->fd_table[i] = NULL;
-    }
-  }
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table에 있는 파일, 파이프 모두 닫아줌
+  fd_close_all();
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 페이지 UPAGE에 이미 뭔가 있나
+// 매핑돼 있거나, VM이면 아직 안 올라왔어도 보조 페이지 테이블에 있으면 true
+// (공유 메모리, uring, 스레드 스택을 기존 페이지 위에 겹쳐 매핑하지 않도록)
+bool
+process_page_in_use (const void *upage)
+{
+#ifdef VM
+  return page_accessible (upage, false);
+#else
+  return pagedir_get_page (thread_current ()->pagedir, upage) != NULL;
+#endif
 }
 
 /* Sets up the CPU for running user code in the current
@@ -227,6 +745,9 @@ process_activate (void)
   /* Set thread's kernel stack for use in processing
      interrupts. */
   tss_update ();
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - FPU 레지스터가 남의 것이면 처음 쓸 때 #NM (userprog/fpu.c)
+  fpu_activate ();
 }
 
 /* We load ELF binaries.  The following definitions are taken
@@ -293,6 +814,7 @@ struct Elf32_Phdr
 #define PF_R 4          /* Readable. */
 
 static bool setup_stack (void **esp);
+static bool parse_elf (struct file *, struct elf_image *);
 static bool validate_segment (const struct Elf32_Phdr *, struct file *);
 static bool load_segment (struct file *file, off_t ofs, uint8_t *upage,
                           uint32_t read_bytes, uint32_t zero_bytes,
@@ -306,9 +828,8 @@ bool
 load (const char *file_name, void (**eip) (void), void **esp) 
 {
   struct thread *t = thread_current ();
-  struct Elf32_Ehdr ehdr;
+  struct elf_image image;
   struct file *file = NULL;
-  off_t file_ofs;
   bool success = false;
   int i;
 
@@ -317,6 +838,10 @@ load (const char *file_name, void (**eip) (void), void **esp)
   if (t->pagedir == NULL) 
     goto done;
   process_activate ();
+#ifdef VM
+  if (!page_table_init ())
+    goto done;
+#endif
 
   /* Open executable file. */
   file = filesys_open (file_name);
@@ -330,33 +855,83 @@ load (const char *file_name, void (**eip) (void), void **esp)
   t->cur_file = file;
   file_deny_write(t->cur_file);
 
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 같은 파일을 전에 파싱한 적 있으면 헤더를 다시 안 읽음 (userprog/elf-cache.c)
+  if (!elf_cache_lookup (file, &image))
+    {
+      if (!parse_elf (file, &image))
+        {
+          printf ("load: %s: error loading executable\n", file_name);
+          goto done; 
+        }
+      elf_cache_insert (file, &image);
+    }
+
+  /* Load segments. */
+  for (i = 0; i < image.seg_cnt; i++)
+    {
+      const struct elf_segment *seg = &image.segs[i];
+      if (!load_segment (file, seg->file_page, (void *) seg->mem_page,
+                         seg->read_bytes, seg->zero_bytes, seg->writable))
+        goto done;
+    }
+
+  /* Set up stack. */
+  if (!setup_stack (esp))
+    goto done;
+
+  /* Start address. */
+  *eip = (void (*) (void)) image.entry;
+
+  success = true;
+
+ done:
+  /* We arrive here whether the load is successful or not. */
+  // ❌❌❌❌❌ - process_exit()에서 파일을 닫아야함
+  // file_close (file);
+  return success;
+}
+
+/* Reads and verifies FILE's executable header and program
+   headers, and stores the entry point and the layout of its
+   loadable segments into *IMAGE.  Returns true if successful,
+   false if FILE is not a valid executable. */
+static bool
+parse_elf (struct file *file, struct elf_image *image)
+{
+  struct Elf32_Ehdr ehdr;
+  struct Elf32_Phdr *phdrs;
+  size_t phdrs_size;
+  bool success = false;
+  int i;
+
   /* Read and verify executable header. */
-  if (file_read (file, &ehdr, sizeof ehdr) != sizeof ehdr
+  if (file_read_at (file, &ehdr, sizeof ehdr, 0) != sizeof ehdr
       || memcmp (ehdr.e_ident, "\177ELF\1\1\1", 7)
       || ehdr.e_type != 2
       || ehdr.e_machine != 3
       || ehdr.e_version != 1
       || ehdr.e_phentsize != sizeof (struct Elf32_Phdr)
       || ehdr.e_phnum > 1024) 
-    {
-      printf ("load: %s: error loading executable\n", file_name);
-      goto done; 
-    }
+    return false;
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 프로그램 헤더를 하나씩 seek + read 하지 않고 한 번에 읽음
+  phdrs_size = ehdr.e_phnum * sizeof *phdrs;
+  if (ehdr.e_phoff > (Elf32_Off) file_length (file))
+    return false;
+  phdrs = malloc (phdrs_size > 0 ? phdrs_size : 1);
+  if (phdrs == NULL)
+    return false;
+  if (file_read_at (file, phdrs, phdrs_size, ehdr.e_phoff)
+      != (off_t) phdrs_size)
+    goto done;
 
-  /* Read program headers. */
-  file_ofs = ehdr.e_phoff;
+  image->entry = ehdr.e_entry;
+  image->seg_cnt = 0;
   for (i = 0; i < ehdr.e_phnum; i++) 
     {
-      struct Elf32_Phdr phdr;
-
-      if (file_ofs < 0 || file_ofs > file_length (file))
-        goto done;
-      file_seek (file, file_ofs);
+      struct Elf32_Phdr *phdr = &phdrs[i];
 
-      if (file_read (file, &phdr, sizeof phdr) != sizeof phdr)
-        goto done;
-      file_ofs += sizeof phdr;
-      switch (phdr.p_type) 
+      switch (phdr->p_type) 
         {
         case PT_NULL:
         case PT_NOTE:
@@ -370,54 +945,45 @@ load (const char *file_name, void (**eip) (void), void **esp)
         case PT_SHLIB:
           goto done;
         case PT_LOAD:
-          if (validate_segment (&phdr, file)) 
+          if (validate_segment (phdr, file)
+              && image->seg_cnt < ELF_SEG_MAX) 
             {
-              bool writable = (phdr.p_flags & PF_W) != 0;
-              uint32_t file_page = phdr.p_offset & ~PGMASK;
-              uint32_t mem_page = phdr.p_vaddr & ~PGMASK;
-              uint32_t page_offset = phdr.p_vaddr & PGMASK;
-              uint32_t read_bytes, zero_bytes;
-              if (phdr.p_filesz > 0)
+              struct elf_segment *seg = &image->segs[image->seg_cnt++];
+              uint32_t page_offset = phdr->p_vaddr & PGMASK;
+
+              seg->writable = (phdr->p_flags & PF_W) != 0;
+              seg->file_page = phdr->p_offset & ~PGMASK;
+              seg->mem_page = phdr->p_vaddr & ~PGMASK;
+              if (phdr->p_filesz > 0)
                 {
                   /* Normal segment.
                      Read initial part from disk and zero the rest. */
-                  read_bytes = page_offset + phdr.p_filesz;
-                  zero_bytes = (ROUND_UP (page_offset + phdr.p_memsz, PGSIZE)
-                                - read_bytes);
+                  seg->read_bytes = page_offset + phdr->p_filesz;
+                  seg->zero_bytes = (ROUND_UP (page_offset + phdr->p_memsz,
+                                               PGSIZE)
+                                     - seg->read_bytes);
                 }
               else 
                 {
                   /* Entirely zero.
                      Don't read anything from disk. */
-                  read_bytes = 0;
-                  zero_bytes = ROUND_UP (page_offset + phdr.p_memsz, PGSIZE);
+                  seg->read_bytes = 0;
+                  seg->zero_bytes = ROUND_UP (page_offset + phdr->p_memsz,
+                                              PGSIZE);
                 }
-              if (!load_segment (file, file_page, (void *) mem_page,
-                                 read_bytes, zero_bytes, writable))
-                goto done;
             }
           else
             goto done;
           break;
         }
     }
-
-  /* Set up stack. */
-  if (!setup_stack (esp))
-    goto done;
-
-  /* Start address. */
-  *eip = (void (*) (void)) ehdr.e_entry;
-
   success = true;
 
  done:
-  /* We arrive here whether the load is successful or not. */
-  // ❌❌❌❌❌ - process_exit()에서 파일을 닫아야함
-  // file_close (file);
+  free (phdrs);
   return success;
 }
-
+
 /* load() helpers. */
 
 static bool install_page (void *upage, void *kpage, bool writable);
@@ -489,7 +1055,6 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
   ASSERT (pg_ofs (upage) == 0);
   ASSERT (ofs % PGSIZE == 0);
 
-  file_seek (file, ofs);
   while (read_bytes > 0 || zero_bytes > 0) 
     {
       /* Calculate how to fill this page.
@@ -498,13 +1063,19 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
       size_t page_read_bytes = read_bytes < PGSIZE ? read_bytes : PGSIZE;
       size_t page_zero_bytes = PGSIZE - page_read_bytes;
 
+#ifdef VM
+      // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 지금 읽지 않고 등록만, 처음 접근할 때 page_fault()에서 읽음 (vm/page.c)
+      if (!page_add_file (upage, file, ofs, page_read_bytes, writable))
+        return false;
+#else
       /* Get a page of memory. */
       uint8_t *kpage = palloc_get_page (PAL_USER);
       if (kpage == NULL)
         return false;
 
       /* Load this page. */
-      if (file_read (file, kpage, page_read_bytes) != (int) page_read_bytes)
+      if (file_read_at (file, kpage, page_read_bytes, ofs)
+          != (int) page_read_bytes)
         {
           palloc_free_page (kpage);
           return false; 
@@ -517,10 +1088,12 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
           palloc_free_page (kpage);
           return false; 
         }
+#endif
 
       /* Advance. */
       read_bytes -= page_read_bytes;
       zero_bytes -= page_zero_bytes;
+      ofs += page_read_bytes;
       upage += PGSIZE;
     }
   return true;
@@ -531,10 +1104,16 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
 static bool
 setup_stack (void **esp) 
 {
-  uint8_t *kpage;
   bool success = false;
 
-  kpage = palloc_get_page (PAL_USER | PAL_ZERO);
+#ifdef VM
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 스택도 보조 페이지 테이블에 등록, 인자를 바로 쌓으니까 지금 올림
+  uint8_t *upage = ((uint8_t *) PHYS_BASE) - PGSIZE;
+  success = page_add_zero (upage, true) && page_in (upage, true);
+  if (success)
+    *esp = PHYS_BASE;
+#else
+  uint8_t *kpage = palloc_get_page (PAL_USER | PAL_ZERO);
   if (kpage != NULL) 
     {
       success = install_page (((uint8_t *) PHYS_BASE) - PGSIZE, kpage, true);
@@ -543,6 +1122,11 @@ setup_stack (void **esp)
       else
         palloc_free_page (kpage);
     }
+#endif
+
+  // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 모든 프로세스가 같이 보는 시간 페이지 (읽기 전용, process_exit()에서 떼어냄)
+  if (success)
+    success = install_page ((void *) VTIME_ADDR, timer_vtime_page (), false);
   return success;
 }
 
@@ -565,3 +1149,92 @@ install_page (void *upage, void *kpage, bool writable)
   return (pagedir_get_page (t->pagedir, upage) == NULL
           && pagedir_set_page (t->pagedir, upage, kpage, writable));
 }
+
+#ifdef VM
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fork()할 때 fork_start()에 넘겨주는 정보 (부모의 스택에 있음)
+struct fork_info
+  {
+    struct thread *parent;      /* fork()를 부른 프로세스. */
+    struct intr_frame if_;      /* 자식이 유저 모드로 돌아갈 때의 레지스터. */
+    struct semaphore done;      /* 자식이 복사를 끝내면 up. */
+    bool success;               /* 복사에 성공했나. */
+  };
+
+/* Clones the current process.  Only the calling thread is
+   copied, and it must be the process's first thread.  The child
+   shares every resident user frame with the parent
+   copy-on-write, reopens the executable and regular files,
+   inherits pipes, and returns 0 from the system call.  Returns
+   the child's tid, or TID_ERROR. */
+tid_t
+process_fork (void)
+{
+  struct thread *cur = thread_current ();
+  struct fork_info info;
+  tid_t tid;
+
+  // 유저 스레드의 스택은 보조 페이지 테이블 밖이라 복사되지 않음 -> 첫 스레드만
+  if (cur->leader != cur)
+    return TID_ERROR;
+
+  // 유저 모드에서 들어온 syscall의 intr_frame은 커널 스택 맨 위(tss의 esp0)에 쌓여 있음
+  info.parent = cur;
+  info.if_ = ((struct intr_frame *) ((uint8_t *) cur + PGSIZE))[-1];
+  info.if_.eax = 0;  // 자식에서 fork()의 리턴값
+  info.success = false;
+  sema_init (&info.done, 0);
+
+  tid = thread_create (cur->name, thread_get_priority (), fork_start, &info);
+  if (tid == TID_ERROR)
+    return TID_ERROR;
+  sema_down (&info.done);
+  if (!info.success)
+    {
+      process_wait (tid);  // 실패한 자식은 바로 회수 (wait-any에 잡히지 않게)
+      return TID_ERROR;
+    }
+  return tid;
+}
+
+// fork()한 자식의 시작, 부모가 기다리는 동안 주소 공간과 fd를 복사하고 부모의 syscall에서 돌아감
+static void
+fork_start (void *info_)
+{
+  struct fork_info *info = info_;
+  struct thread *cur = thread_current ();
+  struct thread *parent = info->parent;
+  struct intr_frame if_ = info->if_;
+  bool success = false;
+
+  cur->pagedir = pagedir_create ();
+  if (cur->pagedir == NULL)
+    goto done;
+  process_activate ();
+  if (!page_table_init ())
+    goto done;
+  if (parent->cur_file != NULL)
+    {
+      cur->cur_file = file_reopen (parent->cur_file);
+      if (cur->cur_file == NULL)
+        goto done;
+      file_deny_write (cur->cur_file);
+    }
+  success = (page_table_fork (parent, cur->cur_file)
+             && install_page ((void *) VTIME_ADDR, timer_vtime_page (), false)
+             && fd_fork (parent)
+             && fpu_copy (parent));
+
+ done:
+  info->success = success;
+  sema_up (&info->done);  // 이 뒤로 INFO는 쓰면 안 됨
+  if (!success)
+    {
+      cur->is_exit = -1;
+      thread_exit ();
+    }
+
+  syscall_stats_start ();
+  asm volatile ("movl %0, %%esp; jmp intr_exit" : : "g" (&if_) : "memory");
+  NOT_REACHED ();
+}
+#endif
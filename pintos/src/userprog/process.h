@@ -5,7 +5,31 @@
 
 tid_t process_execute (const char *file_name);
 int process_wait (tid_t);
+tid_t process_waitpid (tid_t, int *status, bool nohang);
 void process_exit (void);
 void process_activate (void);
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 메인 스택 최대 크기, PHYS_BASE 아래로 여기까지는 fault가 나면 늘려줌 (VM)
+// -DUSER_STACK_MAX=...로 바꿀 수 있음
+#ifndef USER_STACK_MAX
+#define USER_STACK_MAX (8 * 1024 * 1024)
+#endif
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 스레드
+// 스레드 스택은 메인 스택(최대 USER_STACK_MAX) 아래에 UTHREAD_STACK_SIZE 간격으로 한 자리씩
+// 처음엔 맨 위 한 페이지, VM이면 메인 스택처럼 fault가 나면 자리 끝까지 늘어남
+#define UTHREAD_MAX 16
+#define UTHREAD_STACK_SIZE (64 * 1024)
+#define UTHREAD_STACK_TOP(SLOT) \
+  ((uint8_t *) PHYS_BASE - USER_STACK_MAX - (SLOT) * UTHREAD_STACK_SIZE)
+
+tid_t uthread_create (void *entry, void *fn, void *arg);
+int uthread_join (tid_t);
+void process_check_exit (void);
+bool process_set_exiting (void);
+bool process_page_in_use (const void *upage);
+#ifdef VM
+tid_t process_fork (void);
+#endif
+
 #endif /* userprog/process.h */
@@ -0,0 +1,263 @@
+#include "userprog/shm.h"
+#include <debug.h>
+#include <list.h>
+#include <round.h>
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/pagedir.h"
+#include "userprog/process.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 세그먼트는 만든 프로세스가 살아있는 동안 + 누군가 attach하고 있는 동안 유지
+// ref_cnt = 만든 프로세스의 참조 1 + attach 개수, 0이 되면 프레임 해제
+// VM이면 유저 풀은 전부 프레임 테이블(vm/frame.c) 몫 -> 거기서 따로 가져가면 내보낼 수도 없는 프레임이 생김
+// 공유 메모리는 내보내지 않으니까 커널 풀에서 받음 (pagedir_destroy() 전에 떼어내는 건 똑같음)
+#ifdef VM
+#define SHM_PAL_FLAGS PAL_ZERO
+#else
+#define SHM_PAL_FLAGS (PAL_USER | PAL_ZERO)
+#endif
+
+struct shm_segment
+  {
+    int id;                     /* shm_create()가 돌려준 번호. */
+    int ref_cnt;                /* 참조 개수 (shm_lock). */
+    size_t page_cnt;            /* 페이지 개수. */
+    struct list_elem elem;      /* shm_segments 요소. */
+    void *kpages[];             /* 프레임들 (SHM_PAL_FLAGS). */
+  };
+
+// 프로세스마다 가지고 있는 참조 하나 (thread의 shm_list)
+struct shm_ref
+  {
+    struct shm_segment *seg;
+    void *upage;                /* attach한 주소, 만든 프로세스의 참조면 NULL. */
+    struct list_elem elem;
+  };
+
+static struct list shm_segments;        /* 살아있는 세그먼트들. */
+static struct lock shm_lock;            /* shm_segments, ref_cnt 보호. */
+static int next_shm_id;
+
+static void shm_unref (struct shm_segment *);
+static struct shm_ref *add_ref (struct shm_segment *, void *upage);
+static void unmap_pages (struct shm_ref *, size_t page_cnt);
+
+void
+shm_init (void)
+{
+  list_init (&shm_segments);
+  lock_init (&shm_lock);
+  next_shm_id = 1;
+}
+
+// SIZE 바이트 (페이지 단위로 올림) 세그먼트를 만들고 번호를 반환, 실패하면 -1
+// 0으로 채운 프레임을 미리 다 할당해둠 (demand paging 없음)
+int
+shm_create (size_t size)
+{
+  size_t page_cnt = DIV_ROUND_UP (size, PGSIZE);
+  struct shm_segment *seg;
+  struct shm_ref *ref;
+  size_t i;
+  int id;
+
+  if (page_cnt == 0 || page_cnt > SHM_MAX_PAGES)
+    return -1;
+
+  seg = malloc (sizeof *seg + page_cnt * sizeof *seg->kpages);
+  if (seg == NULL)
+    return -1;
+  seg->page_cnt = page_cnt;
+  seg->ref_cnt = 1;
+  for (i = 0; i < page_cnt; i++)
+    {
+      seg->kpages[i] = palloc_get_page (SHM_PAL_FLAGS);
+      if (seg->kpages[i] == NULL)
+        {
+          while (i-- > 0)
+            palloc_free_page (seg->kpages[i]);
+          free (seg);
+          return -1;
+        }
+    }
+
+  lock_acquire (&thread_current ()->leader->proc_lock);
+  ref = add_ref (seg, NULL);
+  lock_release (&thread_current ()->leader->proc_lock);
+  if (ref == NULL)
+    {
+      for (i = 0; i < page_cnt; i++)
+        palloc_free_page (seg->kpages[i]);
+      free (seg);
+      return -1;
+    }
+
+  lock_acquire (&shm_lock);
+  id = seg->id = next_shm_id++;
+  list_push_back (&shm_segments, &seg->elem);
+  lock_release (&shm_lock);
+  return id;
+}
+
+// 세그먼트 ID를 유저 주소 ADDR부터 매핑하고 ADDR 반환
+// ADDR이 페이지 정렬이 안 됐거나, 이미 매핑된 페이지와 겹치거나, 없는 ID면 NULL
+// 겹치는지 확인하고 매핑하는 동안 leader의 proc_lock -> 다른 스레드가 같은 자리에 동시에 attach X
+void *
+shm_attach (int id, void *addr)
+{
+  struct thread *cur = thread_current ();
+  struct thread *leader = cur->leader;
+  struct shm_segment *seg = NULL;
+  struct shm_ref *ref;
+  struct list_elem *e;
+  uint8_t *upage = addr;
+  size_t i;
+
+  if (upage == NULL || pg_ofs (upage) != 0 || !is_user_vaddr (upage))
+    return NULL;
+
+  lock_acquire (&shm_lock);
+  for (e = list_begin (&shm_segments); e != list_end (&shm_segments);
+       e = list_next (e))
+    if (list_entry (e, struct shm_segment, elem)->id == id)
+      {
+        seg = list_entry (e, struct shm_segment, elem);
+        seg->ref_cnt++;
+        break;
+      }
+  lock_release (&shm_lock);
+  if (seg == NULL)
+    return NULL;
+
+  // 끝까지 유저 영역이어야 하고, 이미 있는 페이지(코드, 스택, 다른 세그먼트)와 겹치면 안 됨
+  if (seg->page_cnt * PGSIZE > (size_t) ((uint8_t *) PHYS_BASE - upage))
+    goto fail;
+  lock_acquire (&leader->proc_lock);
+  for (i = 0; i < seg->page_cnt; i++)
+    if (process_page_in_use (upage + i * PGSIZE))
+      goto fail_unlock;
+
+  ref = add_ref (seg, upage);
+  if (ref == NULL)
+    goto fail_unlock;
+  for (i = 0; i < seg->page_cnt; i++)
+    if (!pagedir_set_page (cur->pagedir, upage + i * PGSIZE,
+                           seg->kpages[i], true))
+      {
+        // page table 할당 실패 -> 지금까지 매핑한 것만 되돌림
+        unmap_pages (ref, i);
+        list_remove (&ref->elem);
+        free (ref);
+        goto fail_unlock;
+      }
+  lock_release (&leader->proc_lock);
+  return upage;
+
+ fail_unlock:
+  lock_release (&leader->proc_lock);
+ fail:
+  shm_unref (seg);
+  return NULL;
+}
+
+// ADDR에 attach된 세그먼트를 떼어냄, ADDR에 attach된 게 없으면 false
+bool
+shm_detach (void *addr)
+{
+  struct thread *leader = thread_current ()->leader;
+  struct shm_ref *ref = NULL;
+  struct list_elem *e;
+
+  if (addr == NULL)
+    return false;
+  lock_acquire (&leader->proc_lock);
+  for (e = list_begin (&leader->shm_list); e != list_end (&leader->shm_list);
+       e = list_next (e))
+    if (list_entry (e, struct shm_ref, elem)->upage == addr)
+      {
+        ref = list_entry (e, struct shm_ref, elem);
+        unmap_pages (ref, ref->seg->page_cnt);
+        list_remove (&ref->elem);
+        break;
+      }
+  lock_release (&leader->proc_lock);
+  if (ref == NULL)
+    return false;
+
+  shm_unref (ref->seg);
+  free (ref);
+  return true;
+}
+
+// 프로세스 종료: 모든 attach를 떼어내고 만든 세그먼트의 참조도 놓음
+// pagedir_destroy()가 공유 프레임을 해제하지 않도록 그 전에 호출해야 함
+// 다른 유저 스레드가 다 끝난 뒤라 proc_lock은 필요 없음
+void
+shm_exit (void)
+{
+  struct list *refs = &thread_current ()->leader->shm_list;
+
+  while (!list_empty (refs))
+    {
+      struct shm_ref *ref = list_entry (list_pop_front (refs),
+                                        struct shm_ref, elem);
+      struct shm_segment *seg = ref->seg;
+      if (ref->upage != NULL)
+        unmap_pages (ref, seg->page_cnt);
+      free (ref);
+      shm_unref (seg);
+    }
+}
+
+// 참조 하나를 놓고, 마지막이었으면 세그먼트와 프레임 해제
+static void
+shm_unref (struct shm_segment *seg)
+{
+  bool is_last;
+  size_t i;
+
+  lock_acquire (&shm_lock);
+  ASSERT (seg->ref_cnt > 0);
+  is_last = --seg->ref_cnt == 0;
+  if (is_last)
+    list_remove (&seg->elem);
+  lock_release (&shm_lock);
+
+  if (is_last)
+    {
+      for (i = 0; i < seg->page_cnt; i++)
+        palloc_free_page (seg->kpages[i]);
+      free (seg);
+    }
+}
+
+// 현재 프로세스의 shm_list에 참조 추가 (ref_cnt는 호출한 쪽에서 이미 올려둠)
+// leader의 proc_lock을 잡고 호출
+static struct shm_ref *
+add_ref (struct shm_segment *seg, void *upage)
+{
+  struct shm_ref *ref = malloc (sizeof *ref);
+  if (ref == NULL)
+    return NULL;
+  ref->seg = seg;
+  ref->upage = upage;
+  list_push_back (&thread_current ()->leader->shm_list, &ref->elem);
+  return ref;
+}
+
+// REF가 매핑한 앞쪽 PAGE_CNT 페이지를 page directory에서 지움 (프레임은 안 건드림)
+static void
+unmap_pages (struct shm_ref *ref, size_t page_cnt)
+{
+  uint32_t *pd = thread_current ()->pagedir;
+  size_t i;
+
+  if (pd == NULL)
+    return;
+  for (i = 0; i < page_cnt; i++)
+    pagedir_clear_page (pd, (uint8_t *) ref->upage + i * PGSIZE);
+}
@@ -0,0 +1,17 @@
+#ifndef USERPROG_SHM_H
+#define USERPROG_SHM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 공유 메모리 세그먼트 (shm_create, shm_attach, shm_detach)
+// 같은 물리 프레임을 여러 프로세스의 page directory에 매핑
+#define SHM_MAX_PAGES 256       /* 세그먼트 하나의 최대 크기 (페이지). */
+
+void shm_init (void);
+int shm_create (size_t size);
+void *shm_attach (int id, void *addr);
+bool shm_detach (void *addr);
+void shm_exit (void);
+
+#endif /* userprog/shm.h */
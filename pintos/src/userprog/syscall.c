@@ -1,10 +1,15 @@
 #include "userprog/syscall.h"
+#include <inttypes.h>
+#include <poll.h>
+#include <round.h>
 #include <stdio.h>
+#include <string.h>
 #include <syscall-nr.h>
 #include "threads/interrupt.h"
 #include "threads/thread.h"
 #include "threads/malloc.h"
 #include "threads/vaddr.h"
+#include "userprog/exception.h"
 #include "userprog/pagedir.h"
 #include "threads/thread.h"
 #include "devices/shutdown.h"
@@ -13,48 +18,141 @@
 #include "threads/synch.h"
 #include "devices/input.h"
 #include "filesys/file.h"
+#include "filesys/directory.h"
+#include "threads/palloc.h"
+#include "devices/timer.h"
+#include "userprog/pipe.h"
+#include "userprog/shm.h"
+#include "userprog/uring.h"
+#include "userprog/poll.h"
+#include "userprog/futex.h"
+#include "userprog/elf-cache.h"
+#ifdef VM
+#include "vm/mmap.h"
+#include "vm/page.h"
+#endif
 
 // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - file 여러개 접근 방지 lock
 struct lock file_lock;
 
-bool is_valid_buffer(const void* buffer, unsigned size); // 유효한 버퍼인지 검사
-
-// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
-// 미리 포인터를 검사하고 쓰기
-// - 이 주소가 PHYS_BASE보다 작나?
-// - 이 주소가 페이지 테이블에 매핑되어 있나?
-// pagedir 에서 user address를 uaddr라고 씀
-bool is_valid_user_ptr(const void *uaddr);
-bool is_valid_user_ptr(const void *uaddr) {
-  if (uaddr == NULL) return false;
-  if (!is_user_vaddr(uaddr)) return false; // 유저 영역 주소? (vaddr < PHYS_BASE)
-  struct thread *cur_thread = thread_current();
-  if (pagedir_get_page(cur_thread->pagedir, uaddr) == NULL) return false; // physical address 매핑 안됐다면 NULL
-  return true;
-}
+bool is_valid_buffer(const void* buffer, unsigned size, bool write); // 유효한 버퍼인지 검사
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table 한 칸 (열린 파일 또는 파이프의 한쪽 끝)
+enum fd_type
+  {
+    FD_FILE,                    /* 일반 파일. */
+    FD_PIPE_READ,               /* 파이프의 읽는 쪽. */
+    FD_PIPE_WRITE               /* 파이프의 쓰는 쪽. */
+  };
+
+// fd_table 자리 1 + 지금 쓰고 있는 syscall 수만큼 참조
+// 다른 스레드가 close()해도 read()/write() 중인 스레드가 fd_put()할 때까지는 안 닫힘
+struct fd
+  {
+    enum fd_type type;
+    struct file *file;          /* FD_FILE일 때. */
+    struct pipe *pipe;          /* FD_PIPE_*일 때. */
+    int ref_cnt;                /* 참조 개수 (leader의 proc_lock). */
+  };
+
+static struct fd *fd_get (int fd);
+static struct fd *fd_get_file (int fd);
+static void fd_put (struct fd *desc);
+static int fd_install (struct fd *desc);
+static void fd_release (struct fd *desc);
+static int fd_poll (int fd);
 
 // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 미리 포인터를 검사하지 않고 일단 접근 -> 잘못된 주소면 page_fault()가 복구
+// 접근하는 명령어(1:)를 예외 테이블에 올려두면 page_fault()가 거기서 난 fault만
+// 바로 뒤(2:)로 점프시키고 eax를 -1로 바꿔줌 (userprog/exception.c)
 /* Reads a byte at user virtual address UADDR.
    UADDR must be below PHYS_BASE.
    Returns the byte value if successful, -1 if a segfault
    occurred. */
-static int get_user(const uint8_t *uaddr) {
-  if (!is_valid_user_ptr(uaddr))
-      return -1;
-  return *uaddr;
+static inline int
+get_user (const uint8_t *uaddr)
+{
+  int result;
+  asm ("1: movzbl %1, %0; 2:\n"
+       EX_TABLE_ENTRY ("1b", "2b")
+       : "=a" (result) : "m" (*uaddr));
+  return result;
 }
 
-// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
 /* Writes BYTE to user address UDST.
    UDST must be below PHYS_BASE.
    Returns true if successful, false if a segfault occurred. */
-static bool put_user(uint8_t *udst, uint8_t byte) {
-  if (!is_valid_user_ptr(udst))
-      return false;
-  *udst = byte;
-  return true;
+static inline bool
+put_user (uint8_t *udst, uint8_t byte)
+{
+  int error_code = 0;
+  asm ("1: movb %b2, %1; 2:\n"
+       EX_TABLE_ENTRY ("1b", "2b")
+       : "+a" (error_code), "=m" (*udst) : "q" (byte));
+  return error_code != -1;
 }
 
+/* Copies SIZE bytes from SRC to DST with one REP MOVSB, where
+   one of them is a user address already checked to be below
+   PHYS_BASE.  Returns true if successful, false if a segfault
+   occurred partway. */
+static inline bool
+copy_user (void *dst, const void *src, size_t size)
+{
+  int error_code = 0;
+  asm volatile ("1: rep movsb; 2:\n"
+                EX_TABLE_ENTRY ("1b", "2b")
+                : "+a" (error_code), "+D" (dst), "+S" (src), "+c" (size)
+                : : "memory");
+  return error_code != -1;
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 유저 주소 USRC에서 SIZE 바이트를 커널 버퍼 DST로 복사
+// 페이지 테이블은 보지 않음, 중간에 fault가 나면 false
+// (rep movsb 한 번, 올라와 있지 않은 페이지는 page_fault()가 올리고 그 자리부터 계속)
+bool
+copy_from_user (void *dst, const void *usrc, size_t size)
+{
+  const uint8_t *s = usrc;
+
+  if (size == 0) return true;
+  if (s + size < s || !is_user_vaddr(s + size - 1)) return false;  // 끝까지 유저 영역이어야 함
+  return copy_user(dst, usrc, size);
+}
+
+// 커널 버퍼 SRC의 SIZE 바이트를 유저 주소 UDST로 복사, fault가 나면 false
+bool
+copy_to_user (void *udst, const void *src, size_t size)
+{
+  uint8_t *d = udst;
+
+  if (size == 0) return true;
+  if (d + size < d || !is_user_vaddr(d + size - 1)) return false;
+  return copy_user(udst, src, size);
+}
+
+// 유저 문자열 USRC를 최대 SIZE 바이트(NULL 포함)까지 DST로 복사
+// 성공하면 문자열 길이, SIZE 안에 NULL이 없으면 SIZE (DST는 잘린 문자열), fault면 -1
+int
+strncpy_from_user (char *dst, const char *usrc, size_t size)
+{
+  size_t len;
+
+  ASSERT (size > 0);
+  for (len = 0; len < size; len++) {
+    const uint8_t *p = (const uint8_t *) usrc + len;
+    int byte;
+    if (!is_user_vaddr(p)) return -1;
+    byte = get_user(p);
+    if (byte == -1) return -1;
+    dst[len] = byte;
+    if (byte == '\0') return len;
+  }
+  dst[size - 1] = '\0';
+  return size;
+}
 
 // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
 typedef int pid_t;
@@ -72,6 +170,104 @@ int write(int fd, const void *buffer, unsigned size); // 파일이나 콘솔에
 void seek(int fd, unsigned position); // 파일 읽기/쓰기 위치 바꾸기
 unsigned tell(int fd);         // 파일 현재 위치 알아오기
 void close(int fd);            // 파일 닫기
+int getrusage(int who, struct rusage *usage); // 자원 사용량 알아오기
+pid_t spawn(const char *cmd_line); // load를 기다리지 않고 새 프로그램 실행
+pid_t waitpid(pid_t pid, int *status, int options); // 아무 자식이나 / 안 기다리고 회수
+int pipe(int *fds);            // 익명 파이프 만들기
+int poll(struct pollfd *fds, unsigned nfds, int timeout); // 여러 fd 중 준비된 것 기다리기
+#ifdef VM
+mapid_t mmap(int fd, void *addr); // 파일을 메모리에 매핑
+void munmap(mapid_t mapping);     // 매핑 해제
+#endif
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - syscall dispatch table
+// 각 syscall이 스택에서 몇 개의 인자(word)를 받는지 여기 한 곳에만 적어둠
+// handler는 복사된 인자 배열을 받아서 eax에 들어갈 값을 리턴 (void syscall은 0)
+#define SYSCALL_MAX_ARGS 3
+
+typedef uint32_t syscall_func (const uint32_t *args);
+
+struct syscall_entry
+  {
+    int argc;                   /* syscall 번호 다음에 오는 인자 개수. */
+    syscall_func *func;         /* 처리 함수, 아직 없으면 NULL. */
+    const char *name;           /* syscall 이름 (디버깅용). */
+  };
+
+static syscall_func sys_halt, sys_exit, sys_exec, sys_wait, sys_create,
+  sys_remove, sys_open, sys_filesize, sys_read, sys_write, sys_seek,
+  sys_tell, sys_close, sys_getrusage, sys_spawn, sys_waitpid, sys_pipe,
+  sys_shm_create, sys_shm_attach, sys_shm_detach, sys_uring_setup,
+  sys_uring_enter, sys_poll, sys_futex, sys_thread_create, sys_thread_join,
+  sys_thread_exit, sys_msleep;
+#ifdef VM
+static syscall_func sys_mmap, sys_munmap, sys_fork;
+#endif
+
+// 아직 구현 안 한 syscall도 인자 개수는 미리 적어둠 -> func만 채우면 됨
+static const struct syscall_entry syscall_table[] =
+  {
+    [SYS_HALT]     = {0, sys_halt, "halt"},
+    [SYS_EXIT]     = {1, sys_exit, "exit"},
+    [SYS_EXEC]     = {1, sys_exec, "exec"},
+    [SYS_WAIT]     = {1, sys_wait, "wait"},
+    [SYS_CREATE]   = {2, sys_create, "create"},
+    [SYS_REMOVE]   = {1, sys_remove, "remove"},
+    [SYS_OPEN]     = {1, sys_open, "open"},
+    [SYS_FILESIZE] = {1, sys_filesize, "filesize"},
+    [SYS_READ]     = {3, sys_read, "read"},
+    [SYS_WRITE]    = {3, sys_write, "write"},
+    [SYS_SEEK]     = {2, sys_seek, "seek"},
+    [SYS_TELL]     = {1, sys_tell, "tell"},
+    [SYS_CLOSE]    = {1, sys_close, "close"},
+#ifdef VM
+    [SYS_MMAP]     = {2, sys_mmap, "mmap"},
+    [SYS_MUNMAP]   = {1, sys_munmap, "munmap"},
+#else
+    [SYS_MMAP]     = {2, NULL, "mmap"},
+    [SYS_MUNMAP]   = {1, NULL, "munmap"},
+#endif
+    [SYS_CHDIR]    = {1, NULL, "chdir"},
+    [SYS_MKDIR]    = {1, NULL, "mkdir"},
+    [SYS_READDIR]  = {2, NULL, "readdir"},
+    [SYS_ISDIR]    = {1, NULL, "isdir"},
+    [SYS_INUMBER]  = {1, NULL, "inumber"},
+    [SYS_GETRUSAGE] = {2, sys_getrusage, "getrusage"},
+    [SYS_SPAWN]    = {1, sys_spawn, "spawn"},
+    [SYS_WAITPID]  = {3, sys_waitpid, "waitpid"},
+    [SYS_PIPE]     = {1, sys_pipe, "pipe"},
+    [SYS_SHM_CREATE] = {1, sys_shm_create, "shm_create"},
+    [SYS_SHM_ATTACH] = {2, sys_shm_attach, "shm_attach"},
+    [SYS_SHM_DETACH] = {1, sys_shm_detach, "shm_detach"},
+    [SYS_URING_SETUP] = {1, sys_uring_setup, "uring_setup"},
+    [SYS_URING_ENTER] = {1, sys_uring_enter, "uring_enter"},
+    [SYS_POLL]     = {3, sys_poll, "poll"},
+    [SYS_FUTEX]    = {3, sys_futex, "futex"},
+    [SYS_THREAD_CREATE] = {3, sys_thread_create, "thread_create"},
+    [SYS_THREAD_JOIN] = {1, sys_thread_join, "thread_join"},
+    [SYS_THREAD_EXIT] = {0, sys_thread_exit, "thread_exit"},
+    [SYS_MSLEEP]   = {1, sys_msleep, "msleep"},
+#ifdef VM
+    [SYS_FORK]     = {0, sys_fork, "fork"},
+#else
+    [SYS_FORK]     = {0, NULL, "fork"},
+#endif
+  };
+
+#define SYSCALL_CNT ((int) (sizeof syscall_table / sizeof *syscall_table))
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - -strace 옵션 (threads/init.c에서 설정)
+// NULL이면 추적 안 함, ""이면 모든 프로세스, "a,b"면 이름이 a나 b인 프로세스만
+const char *syscall_strace;
+
+// -strace 대상 프로세스마다 하나씩 malloc (대상이 아니면 thread의 sc_stats는 NULL)
+struct syscall_stats
+  {
+    unsigned cnt[SYSCALL_CNT];          /* syscall 번호별 호출 횟수. */
+    uint64_t cycles[SYSCALL_CNT];       /* syscall 번호별 누적 시간 (cycle). */
+    unsigned lock_cnt;                  /* file_lock 획득 횟수. */
+    uint64_t lock_cycles;               /* file_lock 기다린 누적 시간 (cycle). */
+  };
 
 void
 syscall_init (void) 
@@ -80,167 +276,382 @@ syscall_init (void)
 
   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 파일 작업 락 초기화
   lock_init (&file_lock);
+
+  shm_init ();
+  pipe_init ();
+  futex_init ();
+  elf_cache_init ();
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 프로세스 이름이 -strace 목록에 있는지 확인
+static bool
+strace_selected (const char *name)
+{
+  const char *p = syscall_strace;
+  size_t len = strlen(name);
+
+  if (*p == '\0') return true;  // 이름 없이 -strace만 주면 전부
+  while (p != NULL) {
+    const char *comma = strchr(p, ',');
+    size_t n = comma != NULL ? (size_t) (comma - p) : strlen(p);
+    if (n == len && !memcmp(p, name, len)) return true;
+    p = comma != NULL ? comma + 1 : NULL;
+  }
+  return false;
 }
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 새 프로세스가 -strace 대상이면 통계 공간 할당 (start_process에서 호출)
+void
+syscall_stats_start (void)
+{
+  struct thread *cur = thread_current();
+  if (syscall_strace != NULL && strace_selected(cur->name))
+    cur->sc_stats = calloc(1, sizeof *cur->sc_stats);
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 프로세스 종료 시 syscall별 횟수와 누적 시간 출력 후 해제
+void
+syscall_stats_done (void)
+{
+  struct thread *cur = thread_current();
+  struct syscall_stats *stats = cur->sc_stats;
+  int i;
+
+  if (stats == NULL) return;
+  printf("%s: syscall statistics\n", cur->name);
+  for (i = 0; i < SYSCALL_CNT; i++)
+    if (stats->cnt[i] > 0)
+      printf("  %-10s %8u calls %12llu cycles\n",
+             syscall_table[i].name, stats->cnt[i], stats->cycles[i]);
+  printf("  %-10s %8u waits %12llu cycles\n",
+         "file_lock", stats->lock_cnt, stats->lock_cycles);
+
+  cur->sc_stats = NULL;
+  free(stats);
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - "이름: syscall(인자...) = 리턴값 <시간>" 한 줄 출력
+// RET이 NULL이면 리턴하지 않는 syscall (exit, halt)
 static void
-syscall_handler (struct intr_frame *f UNUSED) 
+strace_print (const struct syscall_entry *sc, const uint32_t *args,
+              const uint32_t *ret, uint64_t cycles)
 {
-  // ❌❌❌❌❌
-  // printf ("system call!\n");
-  // thread_exit ();
+  int i;
+
+  printf("[strace] %s: %s(", thread_name(), sc->name);
+  for (i = 0; i < sc->argc; i++)
+    printf(i == 0 ? "%#"PRIx32 : ", %#"PRIx32, args[i]);
+  if (ret == NULL)
+    printf(") = ?\n");
+  else
+    printf(") = %d <%llu cycles>\n", (int) *ret, cycles);
+}
 
+static void
+syscall_handler (struct intr_frame *f) 
+{
   // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
-  // 여기서 f->eaxsms System Call 리턴 값을 저장하는 레지스터
-  if (!is_valid_user_ptr(f->esp)) exit(-1);  // 유저 포인터 이상하면 바로 종료
-  
-  int syscall_num = get_user((uint8_t *) f->esp);
-  
-  // 각각 의 syscall에 맞는 인자들을 검사
-  switch (syscall_num) {
-    case SYS_HALT:
-      halt();
-      break;
+  // 1. syscall 번호를 복사해서 테이블에서 찾고
+  // 2. 테이블에 적힌 개수만큼 인자를 한 번에 복사한 뒤
+  // 3. 처리 함수의 리턴값을 f->eax (System Call 리턴 값 레지스터)에 저장
+  const struct syscall_entry *sc;
+  uint32_t args[SYSCALL_MAX_ARGS];
+  int syscall_num;
+
+#ifdef VM
+  thread_current()->user_esp = f->esp;  // 커널이 유저 스택에 접근하다 난 fault에서 스택을 늘릴지 판단
+#endif
+  if (!copy_from_user(&syscall_num, f->esp, sizeof syscall_num)) exit(-1);  // 유저 포인터 이상하면 바로 종료
+
+  if (syscall_num < 0 || syscall_num >= SYSCALL_CNT
+      || syscall_table[syscall_num].func == NULL) {
+    // 이상한 syscall 번호가 들어오면 종료
+    printf("System call number error: %d\n", syscall_num);
+    exit(-1);
+  }
 
-    case SYS_EXIT: {
-      if (!is_valid_user_ptr(f->esp + 4)) exit(-1);
-      int status = *(int *)(f->esp + 4);
-      exit(status);
-      break;
-    }
+  sc = &syscall_table[syscall_num];
+  ASSERT (sc->argc <= SYSCALL_MAX_ARGS);
+  if (!copy_from_user(args, (uint32_t *) f->esp + 1, sc->argc * sizeof *args)) exit(-1);
 
-    case SYS_EXEC: {
-      if (!is_valid_user_ptr(f->esp + 4)) exit(-1);
+  f->eax = syscall_dispatch(syscall_num, args);
+  process_check_exit();  // 다른 스레드가 exit()했으면 유저 모드로 안 돌아감
+}
 
-      const char *cmd_line = *(const char **)(f->esp + 4);
-      if (!is_valid_user_ptr(cmd_line)) exit(-1);
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 이미 커널로 복사된 인자 ARGS로 SYSCALL_NUM번 처리 함수를 호출하고 리턴값 반환
+// syscall_handler()와 uring_enter()가 같이 씀 (-strace도 여기서 한 번에 처리)
+uint32_t
+syscall_dispatch (int syscall_num, const uint32_t *args)
+{
+  struct syscall_stats *stats = thread_current()->leader->sc_stats;  // 스레드들이 같이 씀
+  const struct syscall_entry *sc = &syscall_table[syscall_num];
+  uint32_t ret;
+  uint64_t cycles;
+
+  ASSERT (syscall_num >= 0 && syscall_num < SYSCALL_CNT && sc->func != NULL);
+  if (stats == NULL)
+    return sc->func(args);
+
+  // -strace 대상이면 인자, 리턴값, 걸린 시간을 출력하고 통계에 더함
+  // exit, halt는 리턴하지 않으니까 미리 출력
+  stats->cnt[syscall_num]++;
+  if (syscall_num == SYS_EXIT || syscall_num == SYS_HALT)
+    strace_print(sc, args, NULL, 0);
+
+  // TSC는 끝나고 한 번만 읽어서 통계와 출력에 같은 값
+  cycles = timer_rdtsc();
+  ret = sc->func(args);
+  cycles = timer_rdtsc() - cycles;
+  stats->cycles[syscall_num] += cycles;
+  strace_print(sc, args, &ret, cycles);
+  return ret;
+}
 
-      // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 문자열 전체가 유효한 메모리에 있는지 확인 -> NULL까지 접근 가능
-      const char *p = cmd_line;
-      while (is_user_vaddr(p)) {
-        // p가 유저 영역에 있더라고 해도, 실제로 페이지 테이블에 매핑 안되어있으면 NULL이니까 바로 exit(-1)
-        if (pagedir_get_page(thread_current()->pagedir, p) == NULL)
-          exit(-1);
-        if (*p == '\0') break;  // 문자열 끝이면 검사 끝
-        p++;
-      }
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 파일 이름을 커널 버퍼로 복사
+// NAME_MAX보다 길면 어차피 filesys에서 실패하니까 false (잘못된 주소면 exit)
+static bool
+copy_in_file_name (char name[NAME_MAX + 1], const char *ufile)
+{
+  int len = strncpy_from_user(name, ufile, NAME_MAX + 1);
+  if (len < 0) exit(-1);
+  return len <= NAME_MAX;
+}
 
-      f->eax = exec(cmd_line);
-      break;
-    }
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 테이블에서 호출되는 wrapper들
+// args[]에서 인자를 꺼내 실제 syscall 함수로 넘겨줌
+static uint32_t
+sys_halt (const uint32_t *args UNUSED)
+{
+  halt();
+  NOT_REACHED ();
+}
 
-    case SYS_WAIT: {
-      if (!is_valid_user_ptr(f->esp + 4)) exit(-1);
-      pid_t pid = *(pid_t *)(f->esp + 4);
-      f->eax = wait(pid);
-      break;
-    }
+static uint32_t
+sys_exit (const uint32_t *args)
+{
+  exit((int) args[0]);
+  NOT_REACHED ();
+}
 
-    case SYS_CREATE:
-    {
-        const char *file;
+// 커맨드 라인을 커널 페이지로 복사한 뒤 exec 또는 spawn (process_execute도 PGSIZE까지만 씀)
+static pid_t
+exec_common (const char *ucmd_line, pid_t (*execute) (const char *))
+{
+  char *cmd_line = palloc_get_page(0);
+  pid_t pid;
+  int len;
+
+  if (cmd_line == NULL) return -1;
+  len = strncpy_from_user(cmd_line, ucmd_line, PGSIZE);
+  if (len < 0) {
+    palloc_free_page(cmd_line);
+    exit(-1);
+  }
+  pid = execute(cmd_line);
+  palloc_free_page(cmd_line);
+  return pid;
+}
 
-        unsigned initial_size;
-        if (!is_user_vaddr(f->esp + 4) || !is_user_vaddr(f->esp + 8)) exit(-1);
-        file = *(char **)(f->esp + 4);
-        initial_size = *(unsigned *)(f->esp + 8);
+static uint32_t
+sys_exec (const uint32_t *args)
+{
+  return exec_common((const char *) args[0], exec);
+}
 
-        if (!is_valid_user_ptr(file)) exit(-1);
+static uint32_t
+sys_spawn (const uint32_t *args)
+{
+  return exec_common((const char *) args[0], spawn);
+}
 
-        f->eax = create(file, initial_size);
-        break;
-    }
+static uint32_t
+sys_wait (const uint32_t *args)
+{
+  return wait((pid_t) args[0]);
+}
 
-    case SYS_REMOVE:
-    {
-        const char *file;
-        if (!is_user_vaddr(f->esp + 4)) exit(-1);
-        file = *(char **)(f->esp + 4);
-        f->eax = remove(file);
-        break;
-    }
+static uint32_t
+sys_waitpid (const uint32_t *args)
+{
+  return waitpid((pid_t) args[0], (int *) args[1], (int) args[2]);
+}
 
-    case SYS_OPEN:
-    {
-        const char *file;
-        if (!is_user_vaddr(f->esp + 4)) exit(-1);
-        file = *(char **)(f->esp + 4);
+static uint32_t
+sys_create (const uint32_t *args)
+{
+  char file[NAME_MAX + 1];
+  if (!copy_in_file_name(file, (const char *) args[0])) return false;
+  return create(file, (unsigned) args[1]);
+}
 
-        if (!is_valid_user_ptr(file)) exit(-1);
+static uint32_t
+sys_remove (const uint32_t *args)
+{
+  char file[NAME_MAX + 1];
+  if (!copy_in_file_name(file, (const char *) args[0])) return false;
+  return remove(file);
+}
 
-        f->eax = open(file);
-        break;
-    }
+static uint32_t
+sys_open (const uint32_t *args)
+{
+  char file[NAME_MAX + 1];
+  if (!copy_in_file_name(file, (const char *) args[0])) return -1;
+  return open(file);
+}
 
-    case SYS_FILESIZE:
-    {
-        int fd;
-        if (!is_user_vaddr(f->esp + 4)) exit(-1);
-        fd = *(int *)(f->esp + 4);
-        f->eax = filesize(fd);
-        break;
-    }
+static uint32_t
+sys_filesize (const uint32_t *args)
+{
+  return filesize((int) args[0]);
+}
 
-    case SYS_READ:  // filesize가 구현이 되어있어야 중간에 사용해서 성공함
-    {
-        int fd;
-        void *buffer;
-        unsigned size;
-        if (!is_user_vaddr(f->esp + 4) || !is_user_vaddr(f->esp + 8) || !is_user_vaddr(f->esp + 12)) exit(-1);
-        fd = *(int *)(f->esp + 4);
-        buffer = *(void **)(f->esp + 8);
-        size = *(unsigned *)(f->esp + 12);
-        f->eax = read(fd, buffer, size);
-        break;
-    }
+// filesize가 구현이 되어있어야 중간에 사용해서 성공함
+static uint32_t
+sys_read (const uint32_t *args)
+{
+  int bytes_read = read((int) args[0], (void *) args[1], (unsigned) args[2]);
+  if (bytes_read > 0) thread_current()->ru.bytes_read += bytes_read;
+  return bytes_read;
+}
 
-    case SYS_WRITE:
-    {
-        int fd;
-        const void *buffer;
-        unsigned size;
-        if (!is_user_vaddr(f->esp + 4) || !is_user_vaddr(f->esp + 8) || !is_user_vaddr(f->esp + 12)) exit(-1);
-        fd = *(int *)(f->esp + 4);
-        buffer = *(const void **)(f->esp + 8);
-        size = *(unsigned *)(f->esp + 12);
-        f->eax = write(fd, buffer, size);
-        break;
-    }
+static uint32_t
+sys_write (const uint32_t *args)
+{
+  int bytes_write = write((int) args[0], (const void *) args[1], (unsigned) args[2]);
+  if (bytes_write > 0) thread_current()->ru.bytes_written += bytes_write;
+  return bytes_write;
+}
 
-    case SYS_SEEK:
-    {
-        int fd;
-        unsigned position;
-        if (!is_user_vaddr(f->esp + 4) || !is_user_vaddr(f->esp + 8)) exit(-1);
-        fd = *(int *)(f->esp + 4);
-        position = *(unsigned *)(f->esp + 8);
-        seek(fd, position);
-        break;
-    }
+static uint32_t
+sys_seek (const uint32_t *args)
+{
+  seek((int) args[0], (unsigned) args[1]);
+  return 0;
+}
 
-    case SYS_TELL:
-    {
-        int fd;
-        if (!is_user_vaddr(f->esp + 4)) exit(-1);
-        fd = *(int *)(f->esp + 4);
-        f->eax = tell(fd);
-        break;
-    }
+static uint32_t
+sys_tell (const uint32_t *args)
+{
+  return tell((int) args[0]);
+}
 
-    case SYS_CLOSE:
-    {
-        int fd;
-        if (!is_user_vaddr(f->esp + 4)) exit(-1);
-        fd = *(int *)(f->esp + 4);
-        close(fd);
-        break;
-    }
+static uint32_t
+sys_close (const uint32_t *args)
+{
+  close((int) args[0]);
+  return 0;
+}
 
-    default:
-      // 이상한 syscall 번호가 들어오면 종료
-      printf("System call number error: %d\n", syscall_num);
-      exit(-1);
-  }
+static uint32_t
+sys_getrusage (const uint32_t *args)
+{
+  return getrusage((int) args[0], (struct rusage *) args[1]);
+}
+
+static uint32_t
+sys_pipe (const uint32_t *args)
+{
+  return pipe((int *) args[0]);
+}
+
+// 공유 메모리는 userprog/shm.c에서 전부 처리 (유저 포인터를 역참조하지 않음)
+static uint32_t
+sys_shm_create (const uint32_t *args)
+{
+  return shm_create((size_t) args[0]);
+}
+
+static uint32_t
+sys_shm_attach (const uint32_t *args)
+{
+  return (uint32_t) shm_attach((int) args[0], (void *) args[1]);
+}
+
+static uint32_t
+sys_shm_detach (const uint32_t *args)
+{
+  return shm_detach((void *) args[0]);
+}
+
+// 요청 ring도 userprog/uring.c에서 처리, 요청 하나하나는 다시 syscall_dispatch()로
+static uint32_t
+sys_uring_setup (const uint32_t *args)
+{
+  return (uint32_t) uring_setup((void *) args[0]);
+}
+
+static uint32_t
+sys_uring_enter (const uint32_t *args)
+{
+  return uring_enter((unsigned) args[0]);
+}
+
+static uint32_t
+sys_poll (const uint32_t *args)
+{
+  return poll((struct pollfd *) args[0], (unsigned) args[1], (int) args[2]);
+}
+
+static uint32_t
+sys_futex (const uint32_t *args)
+{
+  return futex((int *) args[0], (int) args[1], (int) args[2]);
+}
+
+// 유저 스레드는 userprog/process.c
+static uint32_t
+sys_thread_create (const uint32_t *args)
+{
+  return uthread_create((void *) args[0], (void *) args[1], (void *) args[2]);
+}
+
+static uint32_t
+sys_thread_join (const uint32_t *args)
+{
+  return uthread_join((tid_t) args[0]);
+}
+
+// 이 스레드만 종료 (프로세스의 첫 스레드면 다른 스레드가 다 끝날 때까지 기다렸다가 프로세스 종료)
+static uint32_t
+sys_thread_exit (const uint32_t *args UNUSED)
+{
+  struct thread *cur = thread_current();
+  if (cur->leader == cur) exit(0);
+  thread_exit();
+}
+
+// 최소 MS 밀리초 동안 잠듦 (CPU를 안 씀, tick 단위는 thread_sleep())
+static uint32_t
+sys_msleep (const uint32_t *args)
+{
+  timer_msleep((unsigned) args[0]);
+  return 0;
+}
+
+#ifdef VM
+// 파일 매핑은 vm/mmap.c
+static uint32_t
+sys_mmap (const uint32_t *args)
+{
+  return mmap((int) args[0], (void *) args[1]);
+}
+
+static uint32_t
+sys_munmap (const uint32_t *args)
+{
+  munmap((mapid_t) args[0]);
+  return 0;
+}
+
+// 프로세스 복제는 userprog/process.c, 자식에게는 0이 리턴됨
+static uint32_t
+sys_fork (const uint32_t *args UNUSED)
+{
+  return process_fork();
 }
+#endif
 
 // 컴퓨터를 꺼버리는 시스템 콜
 // shutdown_power_off() 함수를 호출해서 PintOS를 완전히 종료
@@ -252,10 +663,16 @@ void halt(void) {
 // 현재 스레드를 종료하고, 종료 상태를 반환
 // 만약 부모 프로세스가 자식 프로세스를 wait()하고 있었다면, 이 status 값을 부모가 받아감
 // 0 = 성공 / 0이 아닌 값 = 실패
+// 유저 스레드가 불러도 프로세스 전체가 종료 (다른 스레드는 유저 모드로 돌아가기 전에 종료됨)
+// 다른 스레드가 커널 안에서 기다리고 있으면 process_set_exiting()이 깨움
 void exit(int status) {
-  struct thread *cur_thread = thread_current();
-  cur_thread->is_exit = status;
-  printf("%s: exit(%d)\n", cur_thread->name, status);
+  struct thread *leader = thread_current()->leader;
+  bool is_first = process_set_exiting();  // 여러 스레드가 동시에 exit()해도 출력은 한 번
+
+  if (is_first) {
+    leader->is_exit = status;
+    printf("%s: exit(%d)\n", leader->name, status);
+  }
   thread_exit();
 }
 
@@ -270,11 +687,23 @@ pid_t exec(const char *cmd_line) {
   if (child == NULL) return -1;
 
   sema_down(&child->s_load);  // 자식의 load() 완료까지 대기
-  if (!child->is_load) return -1;
+  if (!child->is_load) {
+    process_wait(tid);  // 실패한 자식은 바로 회수 (wait-any에 잡히지 않게)
+    return -1;
+  }
 
   return tid;
 }
 
+// 새로운 사용자 프로세스를 실행하고, 자식의 load()를 기다리지 않고 바로 pid 반환
+// 부모는 자식이 디스크에서 실행 파일을 읽는 동안 다른 일을 할 수 있음
+// load 실패는 wait()이 -1을 반환하는 걸로 알 수 있음
+pid_t spawn(const char *cmd_line) {
+  tid_t tid = process_execute(cmd_line);  // 새로운 스레드 생성
+  if (tid == TID_ERROR) return -1;
+  return tid;
+}
+
 // 자식 프로세스 pid의 종료를 기다리고 종료 코드를 반환
 // pid가 자식이 아니거나 이미 기다린 경우 -1 반환
 // 자식이 exit()을 호출하면 그 값을 반환
@@ -283,10 +712,46 @@ int wait(pid_t pid){
 }
 
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - file_lock 획득, -strace 대상이면 기다린 시간도 기록
+static void
+file_lock_acquire (void)
+{
+  struct syscall_stats *stats = thread_current()->leader->sc_stats;
+  uint64_t start;
+
+  if (stats == NULL) {
+    lock_acquire(&file_lock);
+    return;
+  }
+  start = timer_rdtsc();
+  lock_acquire(&file_lock);
+  stats->lock_cycles += timer_rdtsc() - start;
+  stats->lock_cnt++;
+}
+
+// waitpid() 옵션 (lib/user/syscall.h와 같은 값), 다른 옵션은 없음
+#define WNOHANG 1
+
+// pid가 -1이면 아무 자식이나, 아니면 그 자식이 종료할 때까지 기다리고 회수
+// options에 WNOHANG(1)이 있으면 기다리지 않음
+// 회수한 자식의 pid를 반환하고 종료 코드는 status에 저장 (status가 NULL이면 저장 안 함)
+// WNOHANG인데 아직 종료한 자식이 없으면 0, 기다릴 자식이 없거나 옵션이 이상하면 -1
+pid_t waitpid(pid_t pid, int *status, int options) {
+  int exit_status;
+  tid_t tid;
+
+  if ((options & ~WNOHANG) != 0) return -1;
+  tid = process_waitpid(pid, &exit_status, (options & WNOHANG) != 0);
+  if (tid == TID_ERROR) return -1;
+  if (tid != 0 && status != NULL && !copy_to_user(status, &exit_status, sizeof *status))
+    exit(-1);
+  return tid;
+}
+
 // 성공하면 true, 실패하면 false
 bool create(const char *file, unsigned initial_size) {
   if(!file) return 0;
-  lock_acquire(&file_lock);
+  file_lock_acquire();
   bool ret = filesys_create(file, initial_size);
   lock_release(&file_lock);
   return ret;
@@ -294,7 +759,7 @@ bool create(const char *file, unsigned initial_size) {
 
 bool remove(const char *file) {
   if(!file) return 0;
-  lock_acquire(&file_lock);
+  file_lock_acquire();
   bool ret = filesys_remove(file);
   lock_release(&file_lock);
   return ret;
@@ -303,28 +768,27 @@ bool remove(const char *file) {
 
 // 성공하면 새로운 파일 디스크립터(fd)를 반환, 실패하면 -1
 int open(const char *file) {
-  lock_acquire(&file_lock);
+  file_lock_acquire();
   struct file *f = filesys_open(file);
   if (f == NULL) {
     lock_release(&file_lock);  // 이거 안하면 deadlock
     return -1;
   }
 
-  struct thread *cur_thread = thread_current();
-  
   // fd = 0(STDIN_FILENO)은 표준 입력, fd = 1(STDOUT_FILENO)은 표준 출력, 실패하면 -1
-  // fd_table index 늘리면서 file discripter 리턴해야하니까 기록
-  int fd = cur_thread->fd_idx++;
-
-  if (fd >= FD_MAX) {
-    printf("File descriptor table is full\n");  // 디버깅용
+  struct fd *desc = malloc(sizeof *desc);
+  int fd = -1;
+  if (desc != NULL) {
+    desc->type = FD_FILE;
+    desc->file = f;
+    desc->pipe = NULL;
+    fd = fd_install(desc);  // 파일 저장
+  }
+  if (fd == -1) {
+    free(desc);
     file_close(f);
-    lock_release(&file_lock);
-    return -1;
   }
 
-  cur_thread->fd_table[fd] = f;  // 파일 저장
-  
   lock_release(&file_lock);
   return fd;
 }
@@ -333,115 +797,508 @@ int open(const char *file) {
 // 잘못된 fd이거나 닫힌 파일이면 -1 반환
 // 내부적으로 file_length() 사용
 int filesize(int fd) {
-  // file descriptor check & file check
-  if (fd < 2 || fd >= FD_MAX) return -1;
-  struct file *f = thread_current()->fd_table[fd];
-  if (f == NULL) return -1;
-
-  return file_length(f);
+  // file descriptor check & file check (파이프는 크기가 없음)
+  struct fd *desc = fd_get_file(fd);
+  int length;
+  if (desc == NULL) return -1;
+
+  length = file_length(desc->file);
+  fd_put(desc);
+  return length;
 }
 
-bool is_valid_buffer(const void* buffer, unsigned size) {
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// read()/write()가 뭔가 하기 전에 유저 버퍼를 미리 검사 (잘못된 버퍼면 바로 exit(-1))
+// 바이트마다 말고, 버퍼가 걸쳐 있는 페이지마다 한 번씩만 확인
+// WRITE면 (read()의 버퍼) 쓸 수 있는 페이지여야 함
+// VM이면 아직 안 올라온 페이지도 보조 페이지 테이블에 있으면 OK (접근할 때 fault로 올라옴)
+bool is_valid_buffer(const void* buffer, unsigned size, bool write) {
+  const uint8_t *start = buffer;
+  const uint8_t *page;
+#ifndef VM
+  struct thread *t = thread_current();
+#endif
+
   if(!buffer) return 0;
+  if(size == 0) return 1;
+  if(start + size < start || !is_user_vaddr(start + size - 1)) return 0;
+
+  for(page = pg_round_down(start); page < start + size; page += PGSIZE)
+#ifdef VM
+    if(!page_accessible(page, write)) return 0;
+#else
+    if(!pagedir_get_page(t->pagedir, page)
+       || (write && !pagedir_is_writable(t->pagedir, page))) return 0;
+#endif
+  return 1;
+}
 
-  char *ptr;
-  struct thread *t = thread_current();
-  for(ptr = (char *)buffer; ptr < (char *)buffer + size; ptr++) {
-    if(!is_user_vaddr(ptr)) return 0;
-    if(!pagedir_get_page(t->pagedir, ptr)) return 0;
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 콘솔 입력 한 글자, 없으면 들어올 때까지 기다림
+// input_getc()에서 잠들면 프로세스가 종료할 때 깨울 수 없으니까 poll()처럼 poll_notify()를 기다림
+// 기다리는 중에 프로세스가 종료하면 -1
+static int
+console_getc (void)
+{
+  struct poll_waiter w;
+  int c = -1;
+
+  poll_register(&w, -1);
+  for (;;) {
+    enum intr_level old_level = intr_disable();  // 확인하고 꺼내는 사이에 다른 스레드가 가져가지 않게
+    if (input_ready()) c = input_getc();
+    intr_set_level(old_level);
+    if (c != -1 || thread_current()->leader->exiting) break;
+    poll_wait(&w);
   }
-  return 1;
+  poll_unregister(&w);
+  return c;
 }
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// read()/write()는 유저 버퍼를 직접 건드리지 않고 스레드의 커널 페이지(io_buf)를 거쳐서 복사
+// -> 유저 주소 접근은 전부 copy_to_user()/copy_from_user()라 fault가 나도 복구됨
+// -> file_lock을 잡은 동안에는 fault가 안 남 (VM의 page_in()이 file_lock을 잡아도 deadlock X)
+// io_buf는 처음 쓸 때 한 번만 할당, 커널 풀이 바닥났으면 스택의 IO_FALLBACK 바이트로 조금씩
+#define IO_FALLBACK 128
+
+// 현재 스레드의 read()/write() 버퍼를 돌려주고 크기를 *SIZE에
+// io_buf를 할당할 수 없으면 호출한 쪽 스택의 FALLBACK (IO_FALLBACK 바이트)
+static uint8_t *
+io_buffer (uint8_t *fallback, unsigned *size)
+{
+  struct thread *cur = thread_current();
+
+  if (cur->io_buf == NULL)
+    cur->io_buf = palloc_get_page(0);
+  if (cur->io_buf == NULL) {
+    *size = IO_FALLBACK;
+    return fallback;
+  }
+  *size = PGSIZE;
+  return cur->io_buf;
+}
 
 // fd로부터 size만큼 데이터를 읽어 buffer에 저장
-// fd == 0이면 키보드에서 입력, 그 외는 파일에서 읽음
+// fd == 0이면 키보드에서 입력, 그 외는 파일(파이프)에서 읽음
 // 읽은 바이트 수 반환, 실패 시 -1
 int read(int fd, void *buffer, unsigned size) {
-
-  if(!is_valid_buffer(buffer, size)) exit(-1);
-
-  // fd == 0: 표준입력
-  if (fd == 0) {
-    int i;
-    for (i = 0; i < size; i++) {
-      // device/input.c의 input_getc()를 사용해서 키보드 입력을 받음
-      ((char *)buffer)[i] = input_getc();  // 한 글자씩
+  struct fd *desc = NULL;
+  uint8_t fallback[IO_FALLBACK];
+  uint8_t *kbuf;
+  unsigned kbuf_size;
+  int total = 0;
+
+  if(!is_valid_buffer(buffer, size, true)) exit(-1);
+
+  // file descriptor check & file check (fd == 0: 표준입력)
+  if (fd != 0) {
+    desc = fd_get(fd);
+    if (desc == NULL) return -1;
+    if (desc->type == FD_PIPE_WRITE) {
+      fd_put(desc);
+      return -1;
     }
-    return size;
   }
+  kbuf = io_buffer(fallback, &kbuf_size);
+
+  while ((unsigned) total < size) {
+    unsigned chunk = size - total < kbuf_size ? size - total : kbuf_size;
+    int n;
+
+    if (desc == NULL) {
+      // 키보드 입력을 한 글자씩 받음, 프로세스가 종료 중이면 그만
+      int c = 0;
+      for (n = 0; n < (int) chunk && (c = console_getc()) != -1; n++)
+        kbuf[n] = c;
+    } else if (desc->type == FD_PIPE_READ) {
+      // 파이프는 비어있으면 block -> file_lock 잡고 기다리면 안 됨
+      n = pipe_read(desc->pipe, kbuf, chunk);
+    } else {
+      file_lock_acquire();
+      n = file_read(desc->file, kbuf, chunk);
+      lock_release(&file_lock);
+    }
 
-  // file descriptor check & file check
-  if (fd < 2 || fd >= FD_MAX) return -1;
-  //? DEBUG
-  // printf("🚨 READ fd=%d, buffer=%p, size=%u\n", fd, buffer, size);
-
-  struct file *f = thread_current()->fd_table[fd];
-  if (f == NULL) return -1;
-
-  // 파일 읽기
-  lock_acquire(&file_lock);
-  int bytes_read = file_read(f, buffer, size);
-  lock_release(&file_lock);
-
-  return bytes_read;
+    if (n > 0 && !copy_to_user((uint8_t *) buffer + total, kbuf, n)) {
+      if (desc != NULL) fd_put(desc);
+      exit(-1);
+    }
+    total += n;
+    // 파일 끝에 닿았거나, 파이프면 지금 있는 만큼만 (한 번에 최대 PIPE_SIZE)
+    if (n < (int) chunk || (desc != NULL && desc->type == FD_PIPE_READ)) break;
+  }
+  if (desc != NULL) fd_put(desc);
+  return total;
 }
 
 
 // fd에 size만큼 buffer 내용을 씀
-// fd == 1이면 콘솔, 그 외에는 열린 파일에 기록
-// 실제로 쓴 바이트 수를 반환
+// fd == 1이면 콘솔, 그 외에는 열린 파일(파이프)에 기록
+// 실제로 쓴 바이트 수를 반환, 파이프의 읽는 쪽이 다 닫혀서 하나도 못 썼으면 -1
 int write(int fd, const void *buffer, unsigned size) {
-  // buffer가 valid한지 확인
-  if(!is_valid_buffer(buffer, size)) exit(-1);
+  struct fd *desc = NULL;
+  uint8_t fallback[IO_FALLBACK];
+  uint8_t *kbuf;
+  unsigned kbuf_size;
+  int total = 0;
 
-  // 콘솔에 출력
-  if (fd == 1) {
-    putbuf(buffer, size);
-    return size;
+  // buffer가 valid한지 확인
+  if(!is_valid_buffer(buffer, size, false)) exit(-1);
+
+  // file descriptor check & file check (fd == 1: 콘솔)
+  if (fd != 1) {
+    desc = fd_get(fd);
+    if (desc == NULL) return -1;
+    if (desc->type == FD_PIPE_READ) {
+      fd_put(desc);
+      return -1;
+    }
   }
+  kbuf = io_buffer(fallback, &kbuf_size);
 
-  // file descriptor check & file check
-  if (fd < 2 || fd >= FD_MAX) return -1;
+  while ((unsigned) total < size) {
+    unsigned chunk = size - total < kbuf_size ? size - total : kbuf_size;
+    int n;
 
-  //? DEBUG
-  // printf("🚨 WRITE fd=%d, buffer=%p, size=%u\n", fd, buffer, size);
-  // hex_dump((uintptr_t)buffer, buffer, 32, true);  // 앞부분만
+    if (!copy_from_user(kbuf, (const uint8_t *) buffer + total, chunk)) {
+      if (desc != NULL) fd_put(desc);
+      exit(-1);
+    }
+    if (desc == NULL) {
+      putbuf((const char *) kbuf, chunk);
+      n = chunk;
+    } else if (desc->type == FD_PIPE_WRITE) {
+      // 파이프도 가득 차 있으면 block -> file_lock 밖에서
+      n = pipe_write(desc->pipe, kbuf, chunk);
+    } else {
+      file_lock_acquire();
+      n = file_write(desc->file, kbuf, chunk);
+      lock_release(&file_lock);
+    }
 
-  struct file *f = thread_current()->fd_table[fd];
-  if (f == NULL) return -1;
+    if (n > 0) total += n;
+    if (n < (int) chunk) break;
+  }
 
-  // 파일에 출력
-  // struct file *cur_file = thread_current()->cur_file;
-  lock_acquire(&file_lock);
-  int bytes_write = file_write(f, buffer, size);
-  lock_release(&file_lock);
-  return bytes_write;
+  if (total == 0 && desc != NULL && desc->type == FD_PIPE_WRITE) total = -1;
+  if (desc != NULL) fd_put(desc);
+  return total;
 }
 
 // fd 파일에서 현재 보고있는 위치를 position으로 변경
 void seek(int fd, unsigned position) {
-  if(fd < 2 || fd >= FD_MAX) return;
-  struct file *f = thread_current()->fd_table[fd];
-  if(!f) return;
-  file_seek(f, position);
+  struct fd *desc = fd_get_file(fd);
+  if(!desc) return;
+  file_seek(desc->file, position);
+  fd_put(desc);
 }
 
 // fd 파일에서 현재 보고있는 위치를 반환
 unsigned tell(int fd) {
-  if(fd < 2 || fd >= FD_MAX) return -1;
-  struct file *f = thread_current()->fd_table[fd];
-  if(!f) return -1;
-  return file_tell(f);
+  struct fd *desc = fd_get_file(fd);
+  unsigned pos;
+  if(!desc) return -1;
+  pos = file_tell(desc->file);
+  fd_put(desc);
+  return pos;
 }
 
 // 파일 디스크립터(fd)를 닫기
 // fd가 표준 입출력(STDIN, STDOUT)이면 무시
 // fd가 범위 밖에 있으면 무시
-// 유효한 fd라면 해당 파일을 닫고 fd_table 엔트리를 NULL로 초기화
+// 유효한 fd라면 fd_table 엔트리를 NULL로 초기화하고 해당 파일(파이프)을 닫음
+// 다른 스레드가 그 fd로 read()/write() 중이면 그게 끝날 때 닫힘
 void close(int fd) {
-  if(fd < 2 || fd >= FD_MAX) return;
+  struct thread *leader = thread_current()->leader;
+  struct fd *desc;
+
+  if (fd < 2 || fd >= FD_MAX) return;
+  lock_acquire(&leader->proc_lock);
+  desc = leader->fd_table[fd];
+  leader->fd_table[fd] = NULL;
+  lock_release(&leader->proc_lock);
+  if (desc != NULL) fd_put(desc);
+}
+
+// 현재 프로세스(RUSAGE_SELF) 또는 wait()으로 회수한 자식들(RUSAGE_CHILDREN)의
+// 자원 사용량을 유저 버퍼 usage에 복사
+// 성공하면 0, who가 이상하면 -1 (usage가 잘못된 주소면 exit(-1))
+int getrusage(int who, struct rusage *usage) {
   struct thread *cur_thread = thread_current();
-  file_close (cur_thread->fd_table[fd]);
-  cur_thread->fd_table[fd] = NULL;
-}
\ No newline at end of file
+  const struct rusage *ru;
+
+  if (who == RUSAGE_SELF) ru = &cur_thread->ru;
+  else if (who == RUSAGE_CHILDREN) ru = &cur_thread->ru_children;
+  else return -1;
+
+  if (!copy_to_user(usage, ru, sizeof *ru)) exit(-1);
+  return 0;
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 익명 파이프를 만들어서 fds[0]에 읽는 쪽, fds[1]에 쓰는 쪽 fd를 넣어줌
+// 성공하면 0, fd_table이 가득 찼거나 메모리가 없으면 -1 (fds가 잘못된 주소면 exit(-1))
+int pipe(int *fds) {
+  struct fd *rd, *wr;
+  struct pipe *p;
+  int kfds[2];
+
+  p = pipe_create();
+  if (p == NULL) return -1;
+  rd = malloc(sizeof *rd);
+  wr = malloc(sizeof *wr);
+  if (rd == NULL || wr == NULL) {
+    free(rd);
+    free(wr);
+    pipe_close(p, true);
+    pipe_close(p, false);
+    return -1;
+  }
+  rd->type = FD_PIPE_READ;
+  wr->type = FD_PIPE_WRITE;
+  rd->file = wr->file = NULL;
+  rd->pipe = wr->pipe = p;
+
+  kfds[0] = fd_install(rd);
+  kfds[1] = kfds[0] != -1 ? fd_install(wr) : -1;
+  if (kfds[1] == -1) {
+    if (kfds[0] != -1) close(kfds[0]);
+    else fd_release(rd);
+    fd_release(wr);
+    return -1;
+  }
+
+  // 여기서 exit(-1)해도 process_exit()이 두 fd를 닫아줌
+  if (!copy_to_user(fds, kfds, sizeof kfds)) exit(-1);
+  return 0;
+}
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// fds[0..nfds-1] 중 하나라도 준비될 때까지 최대 timeout ms 기다림 (음수면 무한, 0이면 안 기다림)
+// 준비된 fd 개수 반환 (timeout이면 0), nfds가 너무 크면 -1 (fds가 잘못된 주소면 exit(-1))
+// 콘솔 입력이나 파이프가 바뀌면 poll_notify()가 깨워주고, 깨어나면 전부 다시 확인
+int poll(struct pollfd *ufds, unsigned nfds, int timeout) {
+  struct poll_waiter w;
+  struct pollfd *fds = NULL;
+  unsigned i;
+  int ready;
+
+  if (nfds > FD_MAX) return -1;
+  if (nfds > 0 && (fds = malloc(nfds * sizeof *fds)) == NULL) return -1;
+  if (!copy_from_user(fds, ufds, nfds * sizeof *fds)) {
+    free(fds);
+    exit(-1);
+  }
+
+  poll_register(&w, timeout < 0 ? -1 : DIV_ROUND_UP((int64_t) timeout * TIMER_FREQ, 1000));
+  for (;;) {
+    ready = 0;
+    for (i = 0; i < nfds; i++) {
+      fds[i].revents = 0;
+      if (fds[i].fd < 0) continue;  // 음수 fd는 무시
+      fds[i].revents = fd_poll(fds[i].fd) & (fds[i].events | POLLERR | POLLHUP | POLLNVAL);
+      if (fds[i].revents != 0) ready++;
+    }
+    if (ready > 0 || poll_expired(&w) || thread_current()->leader->exiting) break;
+    poll_wait(&w);
+  }
+  poll_unregister(&w);
+
+  if (!copy_to_user(ufds, fds, nfds * sizeof *fds)) {
+    free(fds);
+    exit(-1);
+  }
+  free(fds);
+  return ready;
+}
+
+#ifdef VM
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 열린 파일 fd 전체를 addr부터 매핑하고 mapid 반환, 실패하면 MAP_FAILED(-1)
+// 페이지는 접근할 때 파일에서 읽고, 고친 페이지는 munmap이나 종료할 때 파일에 씀
+// 매핑은 파일을 따로 열어두니까 fd를 닫아도 그대로
+mapid_t mmap(int fd, void *addr) {
+  struct fd *desc = fd_get_file(fd);
+  mapid_t mapping;
+
+  if (desc == NULL) return MAP_FAILED;
+  // file_lock은 vm/mmap.c가 필요한 곳에서만 잡음 (페이지를 떼어내면서 파일에 쓸 때도 잡으니까)
+  mapping = mmap_map(desc->file, addr);
+  fd_put(desc);
+  return mapping;
+}
+
+// mmap()이 돌려준 매핑을 해제, 없는 mapping이면 무시
+void munmap(mapid_t mapping) {
+  mmap_unmap(mapping);
+}
+#endif
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table 관리
+// 유저 스레드는 프로세스(leader)의 fd_table을 같이 쓰니까 leader의 proc_lock 안에서만 보고 고침
+// 엔트리를 쓰는 동안은 fd_get()으로 참조를 잡아두고 다 쓰면 fd_put()
+// 락 순서: file_lock -> proc_lock (proc_lock을 잡은 채로 file_lock을 잡지 않음)
+
+// fd에 해당하는 엔트리의 참조를 하나 잡음, 표준 입출력이거나 범위 밖이거나 닫혀 있으면 NULL
+static struct fd *
+fd_get (int fd)
+{
+  struct thread *leader = thread_current()->leader;
+  struct fd *desc;
+
+  if (fd < 2 || fd >= FD_MAX) return NULL;
+  lock_acquire(&leader->proc_lock);
+  desc = leader->fd_table[fd];
+  if (desc != NULL) desc->ref_cnt++;
+  lock_release(&leader->proc_lock);
+  return desc;
+}
+
+// 일반 파일 fd면 fd_get()과 같고, 아니면 NULL (seek, tell, filesize, mmap은 파이프에 의미 없음)
+static struct fd *
+fd_get_file (int fd)
+{
+  struct fd *desc = fd_get(fd);
+  if (desc != NULL && desc->type != FD_FILE) {
+    fd_put(desc);
+    desc = NULL;
+  }
+  return desc;
+}
+
+// fd_get()으로 잡은 참조를 놓음, 이미 close()된 엔트리의 마지막 참조였으면 닫음
+static void
+fd_put (struct fd *desc)
+{
+  struct thread *leader = thread_current()->leader;
+  bool is_last;
+
+  lock_acquire(&leader->proc_lock);
+  is_last = --desc->ref_cnt == 0;
+  lock_release(&leader->proc_lock);
+  if (is_last) fd_release(desc);
+}
+
+// DESC를 새 fd 번호에 등록, fd_table이 가득 찼으면 -1 (DESC는 호출한 쪽이 정리)
+// fd_idx는 계속 늘어나기만 함 (닫힌 번호 재사용 X)
+static int
+fd_install (struct fd *desc)
+{
+  struct thread *cur_thread = thread_current()->leader;
+  int fd = -1;
+
+  desc->ref_cnt = 1;
+  lock_acquire(&cur_thread->proc_lock);
+  if (cur_thread->fd_idx < FD_MAX) {
+    fd = cur_thread->fd_idx++;
+    cur_thread->fd_table[fd] = desc;
+  }
+  lock_release(&cur_thread->proc_lock);
+  if (fd == -1) printf("File descriptor table is full\n");  // 디버깅용
+  return fd;
+}
+
+// 엔트리 하나 해제 (fd_table에서는 이미 뺀 상태, 남은 참조 없음)
+static void
+fd_release (struct fd *desc)
+{
+  if (desc->type == FD_FILE) {
+    file_lock_acquire();
+    file_close(desc->file);
+    lock_release(&file_lock);
+  }
+  else
+    pipe_close(desc->pipe, desc->type == FD_PIPE_WRITE);
+  free(desc);
+}
+
+// poll()용: fd가 지금 막히지 않고 할 수 있는 것
+// 일반 파일은 항상 읽고 쓸 수 있음
+static int
+fd_poll (int fd)
+{
+  struct fd *desc;
+  int events;
+
+  if (fd == 0) return input_ready() ? POLLIN : 0;
+  if (fd == 1) return POLLOUT;
+  desc = fd_get(fd);
+  if (desc == NULL) return POLLNVAL;
+  if (desc->type == FD_FILE) events = POLLIN | POLLOUT;
+  else events = pipe_poll(desc->pipe, desc->type == FD_PIPE_WRITE);
+  fd_put(desc);
+  return events;
+}
+
+// 자식 CHILD에게 파이프 fd를 같은 번호로 물려줌 (thread_create()에서 부모가 호출)
+// 일반 파일은 안 물려줌 -> 자식이 부모 파일 위치를 건드리면 안 됨 (multi-child-fd)
+void
+fd_inherit (struct thread *child)
+{
+  struct thread *cur_thread = thread_current()->leader;
+  int i;
+
+  lock_acquire(&cur_thread->proc_lock);
+  for (i = 2; i < cur_thread->fd_idx && i < FD_MAX; i++) {
+    struct fd *desc = cur_thread->fd_table[i];
+    struct fd *copy;
+
+    if (desc == NULL || desc->type == FD_FILE) continue;
+    copy = malloc(sizeof *copy);
+    if (copy == NULL) continue;
+    *copy = *desc;
+    copy->ref_cnt = 1;
+    pipe_dup(copy->pipe, copy->type == FD_PIPE_WRITE);
+    child->fd_table[i] = copy;
+    child->fd_idx = i + 1;  // 자식이 새로 여는 fd는 물려받은 번호 다음부터
+  }
+  lock_release(&cur_thread->proc_lock);
+}
+
+// fork()한 자식이 부모 PARENT의 일반 파일 fd를 같은 번호로 물려받음 (파이프는 thread_create()가 이미 물려줌)
+// 파일은 따로 다시 열고 위치만 맞춤 -> 위치는 부모와 따로 움직임, 메모리가 모자라면 false
+bool
+fd_fork (struct thread *parent)
+{
+  struct thread *cur_thread = thread_current();
+  bool success = true;
+  int i;
+
+  file_lock_acquire();
+  lock_acquire(&parent->proc_lock);
+  for (i = 2; i < parent->fd_idx && i < FD_MAX; i++) {
+    struct fd *desc = parent->fd_table[i];
+    struct fd *copy;
+
+    if (desc == NULL || desc->type != FD_FILE) continue;
+    copy = malloc(sizeof *copy);
+    if (copy == NULL) {
+      success = false;
+      break;
+    }
+    *copy = *desc;
+    copy->ref_cnt = 1;
+    copy->file = file_reopen(desc->file);
+    if (copy->file == NULL) {
+      free(copy);
+      success = false;
+      break;
+    }
+    file_seek(copy->file, file_tell(desc->file));
+    cur_thread->fd_table[i] = copy;
+  }
+  cur_thread->fd_idx = parent->fd_idx;
+  lock_release(&parent->proc_lock);
+  lock_release(&file_lock);
+  return success;
+}
+
+// 현재 프로세스의 fd를 전부 닫음 (process_exit()에서 호출, 새 유저 스레드는 thread_create()가 복사해준 것 정리)
+void
+fd_close_all (void)
+{
+  int i;
+
+  for (i = 2; i < FD_MAX; i++)
+    close(i);
+}
@@ -1,8 +1,36 @@
 #ifndef USERPROG_SYSCALL_H
 #define USERPROG_SYSCALL_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "threads/synch.h"
+
 void syscall_init (void);
 
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 파일 시스템 전체를 보호하는 lock (VM도 페이지를 파일에서 읽고 쓸 때 잡음)
+// 잡은 채로 유저 메모리를 건드리지 않고 (page fault X), vm_lock을 잡은 채로 잡지 않음
+extern struct lock file_lock;
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - -strace 옵션과 프로세스별 syscall 통계
+extern const char *syscall_strace;
+void syscall_stats_start (void);
+void syscall_stats_done (void);
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 커널로 복사된 인자로 syscall 하나 처리 (userprog/uring.c에서도 사용)
+uint32_t syscall_dispatch (int syscall_num, const uint32_t *args);
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 유저 메모리 복사 (잘못된 주소면 page_fault()가 복구해서 실패 리턴)
+bool copy_from_user (void *dst, const void *usrc, size_t size);
+bool copy_to_user (void *udst, const void *src, size_t size);
+int strncpy_from_user (char *dst, const char *usrc, size_t size);
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - fd_table (파이프 fd는 자식에게 같은 번호로 물려줌, fork()면 일반 파일도)
+struct thread;
+void fd_inherit (struct thread *child);
+void fd_close_all (void);
+bool fd_fork (struct thread *parent);
+
 // Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 모범답안대로라면 여기 한줄이 추가 -> exception.c에서 exit() 호출하기 위해서 정의하는듯
 void exit(int status);
 
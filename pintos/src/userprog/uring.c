@@ -0,0 +1,104 @@
+#include "userprog/uring.h"
+#include <debug.h>
+#include <syscall-nr.h>
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/pagedir.h"
+#include "userprog/process.h"
+#include "userprog/syscall.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// ring은 커널이 할당한 한 페이지, 유저는 ADDR로, 커널은 kernel 주소(thread의 uring)로 접근
+// -> 커널 쪽에서는 get_user/put_user 없이 바로 읽고 씀
+// 프레임은 다른 유저 페이지처럼 process_exit()의 pagedir_destroy()가 해제
+// VM이면 유저 풀은 프레임 테이블(vm/frame.c) 몫이라 커널 풀에서 받음 (ring은 내보내지 않음)
+#ifdef VM
+#define URING_PAL_FLAGS PAL_ZERO
+#else
+#define URING_PAL_FLAGS (PAL_USER | PAL_ZERO)
+#endif
+
+static bool is_batchable (int op);
+
+// 유저 주소 ADDR에 ring 페이지를 매핑하고 ADDR 반환
+// 이미 ring이 있거나, ADDR이 정렬 안 됐거나 이미 매핑된 주소면 NULL
+// 확인하고 매핑하는 동안 leader의 proc_lock -> 두 스레드가 동시에 만들어도 ring은 하나
+void *
+uring_setup (void *addr)
+{
+  struct thread *leader = thread_current ()->leader;
+  void *kpage = NULL;
+
+  ASSERT (sizeof (struct uring) <= PGSIZE);
+
+  if (addr == NULL || pg_ofs (addr) != 0 || !is_user_vaddr (addr))
+    return NULL;
+
+  lock_acquire (&leader->proc_lock);
+  if (leader->uring == NULL && !process_page_in_use (addr))
+    {
+      kpage = palloc_get_page (URING_PAL_FLAGS);
+      if (kpage != NULL && !pagedir_set_page (leader->pagedir, addr, kpage, true))
+        {
+          palloc_free_page (kpage);
+          kpage = NULL;
+        }
+      leader->uring = kpage;
+    }
+  lock_release (&leader->proc_lock);
+  return kpage != NULL ? addr : NULL;
+}
+
+// 요청을 최대 TO_SUBMIT개 순서대로 처리하고 처리한 개수 반환 (ring이 없으면 -1)
+// 요청 하나마다 trap 없이 syscall_dispatch()를 바로 부름
+// completion ring이 가득 차면 거기서 멈춤 -> 남은 요청은 다음 uring_enter()에서
+int
+uring_enter (unsigned to_submit)
+{
+  struct uring *r = thread_current ()->leader->uring;
+  unsigned done;
+
+  if (r == NULL)
+    return -1;
+
+  for (done = 0; done < to_submit; done++)
+    {
+      struct uring_sqe sqe;
+      struct uring_cqe *cqe;
+      uint32_t head = r->sq_head;
+
+      if (head == r->sq_tail
+          || r->cq_tail - r->cq_head >= URING_CQ_ENTRIES)
+        break;
+
+      // 유저가 ring을 마음대로 고칠 수 있으니까 요청은 복사해서 씀
+      sqe = r->sq[head % URING_SQ_ENTRIES];
+      r->sq_head = head + 1;
+
+      cqe = &r->cq[r->cq_tail % URING_CQ_ENTRIES];
+      cqe->user_data = sqe.user_data;
+      cqe->res = is_batchable (sqe.op) ? (int32_t) syscall_dispatch (sqe.op, sqe.args) : -1;
+      barrier ();  // completion 내용을 다 쓴 다음에 tail을 올림
+      r->cq_tail++;
+    }
+  return done;
+}
+
+// ring으로 받아주는 syscall (파일 작업만, 프로세스/메모리 관련은 X)
+static bool
+is_batchable (int op)
+{
+  switch (op)
+    {
+    case SYS_READ:
+    case SYS_WRITE:
+    case SYS_SEEK:
+    case SYS_OPEN:
+    case SYS_CLOSE:
+      return true;
+    default:
+      return false;
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef USERPROG_URING_H
+#define USERPROG_URING_H
+
+#include <uring.h>
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 한 번의 trap으로 여러 syscall을 처리하는 요청 ring (io_uring 비슷)
+void *uring_setup (void *addr);
+int uring_enter (unsigned to_submit);
+
+#endif /* userprog/uring.h */
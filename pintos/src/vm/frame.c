@@ -0,0 +1,401 @@
+#include "vm/frame.h"
+#include <debug.h>
+#include <string.h>
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+#include "userprog/pagedir.h"
+#include "vm/page.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 유저 풀이 바닥나면 second-chance (clock) 알고리즘으로 내보낼 프레임을 고름
+// 시곗바늘이 지나가면서 최근에 접근한(accessed) 프레임은 accessed만 지우고 한 번 봐줌
+// 한 번에 EVICT_CLUSTER개까지 골라서 내보냄 -> 스왑에 연속으로 쓰고,
+// 남는 프레임은 유저 풀에 돌려줘서 다음 몇 번의 할당은 바로 성공
+// 여러 페이지가 같이 쓰는 (fork나 합치기로 공유한) 프레임은 매핑한 페이지를 전부 떼어내고 내보냄
+// (최근 접근은 매핑한 페이지 중 하나라도 accessed면, 스왑에 쓸 내용은 슬롯 하나를 같이 씀)
+// 읽기만 한 0 페이지는 전부 zero_frame 하나를 매핑 (frames에 없으니 내보내지 않음)
+// 실행 파일의 읽기 전용 페이지는 (inode, 오프셋)으로 text_frames에 등록해 두고
+// 같은 페이지가 필요한 다른 프로세스는 디스크에서 읽지 않고 그 프레임을 같이 매핑
+// 마지막 페이지가 떨어지거나 내보내지면 캐시에서도 빠짐
+// 여러 프로세스가 같이 매핑한 코드 프레임도 내보낼 수 있음 -> 안 고친 파일 페이지라 전부 매핑만 지우고 버림
+// (다음에 접근한 프로세스가 파일에서 다시 읽어 캐시에 등록)
+// (실행 중인 파일은 쓰기 금지라 캐시에 있는 동안 내용이 바뀌지 않음)
+// 동기화는 vm/page.c의 vm_lock (frame_* 함수는 전부 그 안에서 호출)
+// page_out()은 내보낼 페이지를 busy로 두고 vm_lock을 놓은 채로 씀
+
+/* Most frames evicted at once. */
+#define EVICT_CLUSTER 8
+
+static struct list frames = LIST_INITIALIZER (frames);
+static struct list_elem *hand;  /* 다음에 볼 프레임, NULL이면 맨 앞부터. */
+static struct list_elem *scan;  /* frame_scan_next()가 다음에 줄 프레임, NULL이면 맨 앞부터. */
+
+static struct hash text_frames;  /* 실행 파일 코드 페이지가 올라와 있는 프레임들. */
+static struct frame zero_frame;  /* 모든 0 페이지가 같이 쓰는 프레임 (frames에 없음). */
+static struct hash stable_frames; /* 내용이 한동안 안 바뀐 프레임들, checksum이 키. */
+
+static struct frame *evict (void);
+static void frame_forget (struct frame *);
+static hash_hash_func text_hash;
+static hash_less_func text_less;
+static hash_hash_func stable_hash;
+static hash_less_func stable_less;
+
+void
+frame_init (void)
+{
+  if (!hash_init (&text_frames, text_hash, text_less, NULL)
+      || !hash_init (&stable_frames, stable_hash, stable_less, NULL))
+    PANIC ("frame_init: out of memory");
+  zero_frame.kpage = palloc_get_page (PAL_USER | PAL_ZERO | PAL_ASSERT);
+  list_init (&zero_frame.pages);
+  zero_frame.pin_cnt = 0;
+  zero_frame.inode = NULL;
+  zero_frame.stable = false;
+}
+
+/* Returns the frame that untouched zero pages map read-only.
+   It is never evicted or freed, and must never be written. */
+struct frame *
+frame_zero (void)
+{
+  return &zero_frame;
+}
+
+/* Allocates a frame without evicting anything.  The caller
+   attaches it to a page with frame_attach() once it is filled.
+   Returns NULL if the user pool is exhausted. */
+struct frame *
+frame_try_alloc (bool zero)
+{
+  struct frame *f;
+  void *kpage = palloc_get_page (PAL_USER | (zero ? PAL_ZERO : 0));
+
+  if (kpage == NULL)
+    return NULL;
+  f = malloc (sizeof *f);
+  if (f == NULL)
+    {
+      palloc_free_page (kpage);
+      return NULL;
+    }
+  f->kpage = kpage;
+  list_init (&f->pages);
+  f->pin_cnt = 0;
+  f->inode = NULL;
+  f->checksum = 0;
+  f->stable = false;
+  list_push_back (&frames, &f->elem);
+  return f;
+}
+
+/* Allocates a frame, evicting other pages if the user pool is
+   exhausted.  Returns NULL if nothing could be evicted. */
+struct frame *
+frame_alloc (bool zero)
+{
+  struct frame *f = frame_try_alloc (zero);
+
+  if (f == NULL)
+    {
+      f = evict ();
+      if (f == NULL)
+        return NULL;
+      if (zero)
+        memset (f->kpage, 0, PGSIZE);
+    }
+  return f;
+}
+
+/* Frees frame F, which no page may be attached to. */
+void
+frame_free (struct frame *f)
+{
+  ASSERT (list_empty (&f->pages));
+  ASSERT (f->pin_cnt == 0);
+
+  frame_forget (f);
+  if (hand == &f->elem)
+    hand = list_next (hand);
+  if (scan == &f->elem)
+    scan = list_next (scan);
+  list_remove (&f->elem);
+  palloc_free_page (f->kpage);
+  free (f);
+}
+
+/* Records that page P is now mapped to frame F. */
+void
+frame_attach (struct frame *f, struct page *p)
+{
+  list_push_back (&f->pages, &p->frame_elem);
+  p->frame = f;
+}
+
+/* Records that page P, which must already be unmapped, no
+   longer uses frame F.  Frees F if P was its last page, unless
+   F is the zero frame or pinned. */
+void
+frame_detach (struct frame *f, struct page *p)
+{
+  ASSERT (p->frame == f);
+
+  list_remove (&p->frame_elem);
+  p->frame = NULL;
+  if (list_empty (&f->pages) && f != &zero_frame && f->pin_cnt == 0)
+    frame_free (f);
+}
+
+/* Pins frame F, so that its contents can be read with vm_lock
+   released: F is neither evicted nor freed until the matching
+   frame_unpin(), although its pages may still be removed or
+   written through. */
+void
+frame_pin (struct frame *f)
+{
+  f->pin_cnt++;
+}
+
+/* Releases a pin taken by frame_pin(), freeing F if no page is
+   left attached. */
+void
+frame_unpin (struct frame *f)
+{
+  ASSERT (f->pin_cnt > 0);
+
+  if (--f->pin_cnt == 0 && list_empty (&f->pages))
+    frame_free (f);
+}
+
+/* Returns true if more than one page is mapped to frame F. */
+bool
+frame_shared (struct frame *f)
+{
+  return list_begin (&f->pages) != list_rbegin (&f->pages);
+}
+
+/* Returns true if a page mapped to frame F is busy, that is,
+   being written out or copied with vm_lock released.  Such a
+   frame must not be evicted, merged or newly mapped. */
+bool
+frame_busy (struct frame *f)
+{
+  struct list_elem *e;
+
+  for (e = list_begin (&f->pages); e != list_end (&f->pages); e = list_next (e))
+    if (list_entry (e, struct page, frame_elem)->busy)
+      return true;
+  return false;
+}
+
+/* Returns the frame holding READ_BYTES bytes of INODE at offset
+   OFS followed by zeros, as registered by frame_add_text(), or
+   NULL if there is none. */
+struct frame *
+frame_find_text (struct inode *inode, off_t ofs, uint32_t read_bytes)
+{
+  struct frame key;
+  struct hash_elem *e;
+
+  key.inode = inode;
+  key.ofs = ofs;
+  key.read_bytes = read_bytes;
+  e = hash_find (&text_frames, &key.text_elem);
+  return e != NULL ? hash_entry (e, struct frame, text_elem) : NULL;
+}
+
+/* Registers frame F, just filled with READ_BYTES bytes of
+   read-only executable INODE at offset OFS followed by zeros, so
+   that other processes can map it instead of reading their
+   own copy.  Does nothing if another frame already holds the
+   same contents. */
+void
+frame_add_text (struct frame *f, struct inode *inode, off_t ofs,
+                uint32_t read_bytes)
+{
+  ASSERT (f->inode == NULL);
+
+  f->inode = inode;
+  f->ofs = ofs;
+  f->read_bytes = read_bytes;
+  if (hash_insert (&text_frames, &f->text_elem) != NULL)
+    f->inode = NULL;
+}
+
+/* Returns the next frame in the frame table, wrapping around at
+   the end, for a background scan that may release vm_lock
+   between calls.  Returns NULL if the table is empty. */
+struct frame *
+frame_scan_next (void)
+{
+  struct frame *f;
+
+  if (list_empty (&frames))
+    return NULL;
+  if (scan == NULL || scan == list_end (&frames))
+    scan = list_begin (&frames);
+  f = list_entry (scan, struct frame, elem);
+  scan = list_next (scan);
+  return f;
+}
+
+/* Returns a frame registered with frame_add_stable() whose
+   contents had checksum CHECKSUM when it was registered, or NULL.
+   The contents may have changed since. */
+struct frame *
+frame_find_stable (unsigned checksum)
+{
+  struct frame key;
+  struct hash_elem *e;
+
+  key.checksum = checksum;
+  e = hash_find (&stable_frames, &key.stable_elem);
+  return e != NULL ? hash_entry (e, struct frame, stable_elem) : NULL;
+}
+
+/* Registers frame F under its current checksum as a candidate
+   for merging, replacing any frame registered under the same
+   checksum. */
+void
+frame_add_stable (struct frame *f)
+{
+  struct hash_elem *old;
+
+  ASSERT (!f->stable);
+
+  old = hash_replace (&stable_frames, &f->stable_elem);
+  if (old != NULL)
+    hash_entry (old, struct frame, stable_elem)->stable = false;
+  f->stable = true;
+}
+
+/* Removes frame F from the merge candidates, if it is one. */
+void
+frame_remove_stable (struct frame *f)
+{
+  if (f->stable)
+    {
+      hash_delete (&stable_frames, &f->stable_elem);
+      f->stable = false;
+    }
+}
+
+// 내용을 버리기 전에 F를 코드 페이지 캐시와 합치기 후보에서 뺌
+static void
+frame_forget (struct frame *f)
+{
+  if (f->inode != NULL)
+    {
+      hash_delete (&text_frames, &f->text_elem);
+      f->inode = NULL;
+    }
+  frame_remove_stable (f);
+  f->checksum = 0;
+}
+
+static unsigned
+text_hash (const struct hash_elem *e, void *aux UNUSED)
+{
+  const struct frame *f = hash_entry (e, struct frame, text_elem);
+  return hash_bytes (&f->inode, sizeof f->inode) ^ hash_int (f->ofs);
+}
+
+static bool
+text_less (const struct hash_elem *a_, const struct hash_elem *b_,
+           void *aux UNUSED)
+{
+  const struct frame *a = hash_entry (a_, struct frame, text_elem);
+  const struct frame *b = hash_entry (b_, struct frame, text_elem);
+
+  if (a->inode != b->inode)
+    return a->inode < b->inode;
+  if (a->ofs != b->ofs)
+    return a->ofs < b->ofs;
+  return a->read_bytes < b->read_bytes;
+}
+
+static unsigned
+stable_hash (const struct hash_elem *e, void *aux UNUSED)
+{
+  return hash_entry (e, struct frame, stable_elem)->checksum;
+}
+
+static bool
+stable_less (const struct hash_elem *a, const struct hash_elem *b,
+             void *aux UNUSED)
+{
+  return (hash_entry (a, struct frame, stable_elem)->checksum
+          < hash_entry (b, struct frame, stable_elem)->checksum);
+}
+
+// 시곗바늘이 가리키는 프레임을 돌려주고 한 칸 전진 (끝에 닿으면 처음으로)
+static struct frame *
+clock_next (void)
+{
+  struct frame *f;
+
+  if (hand == NULL || hand == list_end (&frames))
+    hand = list_begin (&frames);
+  f = list_entry (hand, struct frame, elem);
+  hand = list_next (hand);
+  return f;
+}
+
+// F를 매핑한 페이지 중 하나라도 최근에 접근했으면 true, 전부의 accessed 비트를 지움
+static bool
+test_and_clear_accessed (struct frame *f)
+{
+  struct list_elem *e;
+  bool accessed = false;
+
+  for (e = list_begin (&f->pages); e != list_end (&f->pages); e = list_next (e))
+    {
+      struct page *p = list_entry (e, struct page, frame_elem);
+      if (pagedir_is_accessed (p->pagedir, p->upage))
+        {
+          pagedir_set_accessed (p->pagedir, p->upage, false);
+          accessed = true;
+        }
+    }
+  return accessed;
+}
+
+// 프레임을 최대 EVICT_CLUSTER개 골라 내보내고, 그중 하나를 (frames에 남긴 채) 돌려줌
+// 나머지는 유저 풀에 반납, 하나도 못 내보냈으면 NULL
+static struct frame *
+evict (void)
+{
+  struct frame *victims[EVICT_CLUSTER];
+  size_t frame_cnt = list_size (&frames);
+  size_t victim_cnt = 0, evicted, i;
+
+  // 한 바퀴 돌면 accessed가 다 지워지니까 두 바퀴면 충분
+  for (i = 0; i < 2 * frame_cnt && victim_cnt < EVICT_CLUSTER; i++)
+    {
+      struct frame *f = clock_next ();
+      size_t j;
+
+      // 아직 채우는 중이거나(페이지 없음) I/O 중이거나 고정된 프레임은 건너뜀
+      if (list_empty (&f->pages) || frame_busy (f) || f->pin_cnt > 0)
+        continue;
+      if (test_and_clear_accessed (f))
+        continue;
+      for (j = 0; j < victim_cnt; j++)
+        if (victims[j] == f)
+          break;
+      if (j == victim_cnt)
+        victims[victim_cnt++] = f;
+    }
+  if (victim_cnt == 0)
+    return NULL;
+
+  // 내보낸 프레임이 VICTIMS 앞쪽으로 모임 (스왑이 꽉 차서 못 내보낸 건 그대로 매핑됨)
+  evicted = page_out (victims, victim_cnt);
+  if (evicted == 0)
+    return NULL;
+  for (i = 1; i < evicted; i++)
+    frame_free (victims[i]);
+  frame_forget (victims[0]);
+  return victims[0];
+}
@@ -0,0 +1,56 @@
+#ifndef VM_FRAME_H
+#define VM_FRAME_H
+
+#include <hash.h>
+#include <list.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "filesys/off_t.h"
+
+struct inode;
+struct page;
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 프레임 테이블, 보조 페이지 테이블의 페이지가 올라와 있는 유저 풀 프레임마다 하나
+// fork()하면 부모와 자식의 페이지가 같은 프레임을 읽기 전용으로 같이 매핑 (copy-on-write)
+// 실행 파일의 읽기 전용 페이지(코드)는 같은 파일을 실행하는 프로세스끼리 같이 매핑
+// 아직 안 쓴 0 페이지는 전부 0 프레임 하나를 읽기 전용으로 매핑
+struct frame
+  {
+    void *kpage;                /* 프레임의 커널 주소. */
+    struct list pages;          /* 매핑한 struct page들 (page의 frame_elem). */
+    struct list_elem elem;      /* frames 요소 (clock 순서). */
+    int pin_cnt;                /* 0보다 크면 내보내지 않고, 페이지가 다 떨어져도 해제하지 않음. */
+
+    /* 코드 페이지 캐시 (text_frames)에 있으면 내용의 출처. */
+    struct inode *inode;        /* 실행 파일, 캐시에 없으면 NULL. */
+    off_t ofs;                  /* 파일 오프셋. */
+    uint32_t read_bytes;        /* 파일에서 읽은 바이트 수, 나머지는 0. */
+    struct hash_elem text_elem; /* text_frames 요소. */
+
+    /* 같은 내용 프레임 합치기 (vm/merge.c). */
+    unsigned checksum;          /* 지난번에 훑었을 때의 내용 해시. */
+    bool stable;                /* stable_frames에 있나. */
+    struct hash_elem stable_elem; /* stable_frames 요소. */
+  };
+
+struct frame *frame_try_alloc (bool zero);
+struct frame *frame_alloc (bool zero);
+void frame_free (struct frame *);
+void frame_attach (struct frame *, struct page *);
+void frame_detach (struct frame *, struct page *);
+bool frame_shared (struct frame *);
+bool frame_busy (struct frame *);
+void frame_pin (struct frame *);
+void frame_unpin (struct frame *);
+
+void frame_init (void);
+struct frame *frame_zero (void);
+struct frame *frame_find_text (struct inode *, off_t ofs, uint32_t read_bytes);
+void frame_add_text (struct frame *, struct inode *, off_t ofs,
+                     uint32_t read_bytes);
+struct frame *frame_scan_next (void);
+struct frame *frame_find_stable (unsigned checksum);
+void frame_add_stable (struct frame *);
+void frame_remove_stable (struct frame *);
+
+#endif /* vm/frame.h */
@@ -0,0 +1,212 @@
+#include "vm/merge.h"
+#include <debug.h>
+#include <stdint.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/pagedir.h"
+#include "vm/frame.h"
+#include "vm/page.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 우선순위가 가장 낮은 커널 스레드가 MERGE_INTERVAL_MS마다 프레임을 MERGE_BATCH개씩 훑음
+// 해시는 vm_lock 없이 계산 (그동안 프레임은 고정해 둠), 읽기 전용으로 바꾸고 비교하고 옮길 때만 vm_lock
+// 1. 내용 해시가 지난번에 훑었을 때와 같으면 (한동안 안 바뀌었으면) 후보(stable)로 등록
+// 2. 같은 해시의 다른 후보가 있으면 두 프레임을 매핑한 페이지를 전부 읽기 전용으로 바꾸고 비교
+// 3. 내용이 같으면 한쪽의 페이지들을 다른 쪽 프레임으로 옮기고 빈 프레임은 해제
+// 합친 프레임은 fork()로 공유한 프레임과 똑같이 취급 -> 쓰면 page_copy_on_write()가 다시 나눔
+// 전부 0인 프레임은 0 프레임으로 합침
+// mmap 페이지(고치면 파일에 써야 함)와 코드 페이지 캐시에 있는 프레임은 건드리지 않음
+
+/* Milliseconds between scans, and frames looked at per scan. */
+#define MERGE_INTERVAL_MS 100
+#define MERGE_BATCH 64
+
+static unsigned zero_checksum;  /* 전부 0인 페이지의 해시. */
+
+static thread_func merge_thread NO_RETURN;
+static void merge_frame (struct frame *, unsigned sum);
+static bool mergeable (struct frame *);
+static void write_protect (struct frame *);
+static void move_pages (struct frame *from, struct frame *to);
+static unsigned page_checksum (const void *kpage);
+
+/* Starts the background merging thread.  Must be called after
+   frame_init(). */
+void
+merge_init (void)
+{
+  zero_checksum = page_checksum (frame_zero ()->kpage);
+  if (thread_create ("merge", PRI_MIN, merge_thread, NULL) == TID_ERROR)
+    PANIC ("merge_init: cannot start thread");
+}
+
+static void
+merge_thread (void *aux UNUSED)
+{
+  struct frame *batch[MERGE_BATCH];
+  unsigned sums[MERGE_BATCH];
+
+  for (;;)
+    {
+      struct frame *first;
+      int cnt = 0, i;
+
+      timer_msleep (MERGE_INTERVAL_MS);
+
+      // 이번에 볼 프레임을 고정해서 모음 (그동안 내보내지거나 해제되지 않음)
+      // 프레임이 MERGE_BATCH개보다 적으면 한 바퀴 돌아 처음 프레임이 다시 나옴 -> 거기서 멈춤
+      // (같은 프레임을 두 번 넣으면 두 번째 merge_frame()이 방금 저장한 해시와 비교해서 바로 stable)
+      lock_acquire (&vm_lock);
+      first = NULL;
+      for (i = 0; i < MERGE_BATCH; i++)
+        {
+          struct frame *f = frame_scan_next ();
+          if (f == NULL || f == first)
+            break;
+          if (first == NULL)
+            first = f;
+          if (!mergeable (f))
+            {
+              frame_remove_stable (f);
+              continue;
+            }
+          frame_pin (f);
+          batch[cnt++] = f;
+        }
+      lock_release (&vm_lock);
+
+      // 해시는 vm_lock 없이, 그 사이에 바뀐 내용은 merge_frame()에서 비교할 때 걸러짐
+      for (i = 0; i < cnt; i++)
+        sums[i] = page_checksum (batch[i]->kpage);
+
+      lock_acquire (&vm_lock);
+      for (i = 0; i < cnt; i++)
+        {
+          merge_frame (batch[i], sums[i]);
+          frame_unpin (batch[i]);
+        }
+      lock_release (&vm_lock);
+    }
+}
+
+// 내용 해시가 SUM인 프레임 F를 보고, 지난번과 같은 해시면 같은 내용의 다른 프레임과 합침 (vm_lock)
+static void
+merge_frame (struct frame *f, unsigned sum)
+{
+  struct frame *g;
+
+  // 해시를 계산하는 동안 페이지가 떨어졌거나 I/O 중일 수 있음
+  if (!mergeable (f))
+    {
+      frame_remove_stable (f);
+      return;
+    }
+
+  if (sum != f->checksum)
+    {
+      // 아직 자주 바뀌는 페이지 -> 다음 바퀴에 다시 봄
+      frame_remove_stable (f);
+      f->checksum = sum;
+      return;
+    }
+
+  if (sum == zero_checksum)
+    {
+      write_protect (f);
+      if (!memcmp (f->kpage, frame_zero ()->kpage, PGSIZE))
+        {
+          move_pages (f, frame_zero ());
+          return;
+        }
+    }
+
+  g = frame_find_stable (sum);
+  if (g == f)
+    return;
+  if (g == NULL || !mergeable (g))
+    {
+      if (g != NULL)
+        frame_remove_stable (g);
+      frame_add_stable (f);
+      return;
+    }
+
+  // 읽기 전용으로 바꾼 뒤에 비교해야 비교하고 옮기는 사이에 아무도 못 고침
+  write_protect (f);
+  write_protect (g);
+  if (memcmp (f->kpage, g->kpage, PGSIZE) != 0)
+    {
+      // G가 등록한 뒤에 바뀌었거나 해시 충돌 -> F를 대신 후보로
+      frame_remove_stable (g);
+      frame_add_stable (f);
+      return;
+    }
+  move_pages (f, g);
+}
+
+// F를 다른 프레임과 합쳐도 되나
+// 페이지가 붙어 있어야 하고, 코드 캐시 프레임이나 mmap 페이지, I/O 중인 페이지는 안 됨
+static bool
+mergeable (struct frame *f)
+{
+  struct list_elem *e;
+
+  if (list_empty (&f->pages) || f->inode != NULL || frame_busy (f))
+    return false;
+  for (e = list_begin (&f->pages); e != list_end (&f->pages); e = list_next (e))
+    if (list_entry (e, struct page, frame_elem)->type == PAGE_MMAP)
+      return false;
+  return true;
+}
+
+// F를 매핑한 페이지를 전부 읽기 전용으로 다시 매핑 -> 쓰면 fault가 나서 vm_lock에서 기다림
+// 다시 매핑하면 dirty 비트가 지워지니까 고친 페이지는 PAGE_SWAP으로 (fork()와 같음)
+static void
+write_protect (struct frame *f)
+{
+  struct list_elem *e;
+
+  for (e = list_begin (&f->pages); e != list_end (&f->pages); e = list_next (e))
+    {
+      struct page *p = list_entry (e, struct page, frame_elem);
+
+      if (!pagedir_is_writable (p->pagedir, p->upage))
+        continue;
+      if (pagedir_is_dirty (p->pagedir, p->upage))
+        p->type = PAGE_SWAP;
+      pagedir_clear_page (p->pagedir, p->upage);
+      pagedir_set_page (p->pagedir, p->upage, f->kpage, false);
+    }
+}
+
+// FROM을 매핑한 페이지를 전부 TO에 읽기 전용으로 매핑, 다 옮기면 FROM은 해제됨
+static void
+move_pages (struct frame *from, struct frame *to)
+{
+  while (!list_empty (&from->pages))
+    {
+      struct page *p = list_entry (list_front (&from->pages),
+                                   struct page, frame_elem);
+
+      pagedir_clear_page (p->pagedir, p->upage);
+      frame_detach (from, p);
+      pagedir_set_page (p->pagedir, p->upage, to->kpage, false);
+      frame_attach (to, p);
+    }
+}
+
+// 4KB를 32비트 단위로 훑는 FNV-1a 해시 (hash_bytes()는 바이트 단위라 4배 느림)
+static unsigned
+page_checksum (const void *kpage)
+{
+  const uint32_t *w = kpage;
+  unsigned h = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < PGSIZE / sizeof *w; i++)
+    h = (h ^ w[i]) * 16777619u;
+  return h;
+}
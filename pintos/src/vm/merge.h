@@ -0,0 +1,7 @@
+#ifndef VM_MERGE_H
+#define VM_MERGE_H
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 같은 내용의 유저 프레임을 백그라운드에서 하나로 합침
+void merge_init (void);
+
+#endif /* vm/merge.h */
@@ -0,0 +1,149 @@
+#include "vm/mmap.h"
+#include <list.h>
+#include <round.h>
+#include <stdint.h>
+#include "filesys/file.h"
+#include "threads/malloc.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/process.h"
+#include "userprog/syscall.h"
+#include "vm/page.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// mmap()은 페이지마다 PAGE_MMAP struct page만 등록 -> 읽지도 복사하지도 않음
+// 접근하면 page_in()이 파일에서 바로 유저 프레임으로 읽고 (read()처럼 커널 버퍼를 거치지 않음)
+// 고친 페이지는 munmap, 프로세스 종료, 내보낼 때 파일에 다시 씀 (vm/page.c)
+// 매핑마다 파일을 다시 열어둠 -> fd를 닫거나 파일을 지워도 매핑은 그대로
+// 매핑 목록(leader의 mmaps)은 leader의 proc_lock으로 보호, 파일 연산은 file_lock 안에서
+// 페이지를 떼어낼 때는 둘 다 놓음 (page_remove()가 고친 페이지를 쓰면서 file_lock을 잡음)
+
+/* A file mapping in a process's address space. */
+struct mmap
+  {
+    mapid_t id;                 /* mmap()이 돌려준 번호. */
+    struct file *file;          /* 매핑한 파일 (file_reopen()한 것). */
+    uint8_t *base;              /* 첫 페이지의 유저 주소. */
+    size_t page_cnt;            /* 페이지 수. */
+    struct list_elem elem;      /* leader의 mmaps 요소. */
+  };
+
+static void unmap (struct mmap *);
+
+/* Maps all of FILE, which must have been opened by the current
+   process, into consecutive pages starting at ADDR.  Pages are
+   read on first access and written back when modified.  Fails if
+   FILE is empty, ADDR is null or not page-aligned, or the range
+   would overlap pages already in use or leave user space.
+   Returns the new mapping's id, or MAP_FAILED.  Must be called
+   without file_lock. */
+mapid_t
+mmap_map (struct file *file, void *addr)
+{
+  struct thread *leader = thread_current ()->leader;
+  uint8_t *upage = addr;
+  struct mmap *m;
+  off_t length;
+  size_t page_cnt, i;
+
+  if (upage == NULL || pg_ofs (upage) != 0 || !is_user_vaddr (upage))
+    return MAP_FAILED;
+
+  m = malloc (sizeof *m);
+  if (m == NULL)
+    return MAP_FAILED;
+  lock_acquire (&file_lock);
+  length = file_length (file);
+  m->file = length > 0 ? file_reopen (file) : NULL;
+  lock_release (&file_lock);
+  if (m->file == NULL)
+    {
+      free (m);
+      return MAP_FAILED;
+    }
+  m->base = upage;
+  m->page_cnt = 0;              /* 등록한 페이지 수. */
+  page_cnt = DIV_ROUND_UP (length, PGSIZE);
+
+  // 끝까지 유저 영역이어야 하고, 이미 있는 페이지(코드, 스택, 공유 메모리, 다른 매핑)와 겹치면 안 됨
+  // 검사하고 등록하는 사이에 다른 스레드가 shm_attach() 등으로 끼어들지 못하게 proc_lock 안에서
+  lock_acquire (&leader->proc_lock);
+  if (page_cnt * PGSIZE > (size_t) ((uint8_t *) PHYS_BASE - upage))
+    goto fail;
+  for (i = 0; i < page_cnt; i++)
+    if (process_page_in_use (upage + i * PGSIZE))
+      goto fail;
+
+  for (i = 0; i < page_cnt; i++)
+    {
+      off_t ofs = i * PGSIZE;
+      uint32_t read_bytes = length - ofs < PGSIZE ? length - ofs : PGSIZE;
+      // 그 사이에 다른 스레드가 스택을 늘렸거나 메모리 부족 -> 등록한 것만 되돌림
+      if (!page_add_mmap (upage + ofs, m->file, ofs, read_bytes))
+        goto fail;
+      m->page_cnt++;
+    }
+
+  m->id = leader->next_mapid++;
+  list_push_back (&leader->mmaps, &m->elem);
+  lock_release (&leader->proc_lock);
+  return m->id;
+
+ fail:
+  lock_release (&leader->proc_lock);
+  unmap (m);
+  return MAP_FAILED;
+}
+
+/* Removes mapping ID of the current process, writing modified
+   pages back to the file.  Returns false if there is no such
+   mapping.  Must be called without file_lock. */
+bool
+mmap_unmap (mapid_t id)
+{
+  struct thread *leader = thread_current ()->leader;
+  struct list_elem *e;
+  struct mmap *m = NULL;
+
+  lock_acquire (&leader->proc_lock);
+  for (e = list_begin (&leader->mmaps); e != list_end (&leader->mmaps);
+       e = list_next (e))
+    if (list_entry (e, struct mmap, elem)->id == id)
+      {
+        m = list_entry (e, struct mmap, elem);
+        list_remove (&m->elem);
+        break;
+      }
+  lock_release (&leader->proc_lock);
+
+  if (m == NULL)
+    return false;
+  unmap (m);
+  return true;
+}
+
+/* Removes all of the current process's mappings.  Called from
+   process_exit() before the supplemental page table is
+   destroyed. */
+void
+mmap_exit (void)
+{
+  struct list *mmaps = &thread_current ()->leader->mmaps;
+
+  while (!list_empty (mmaps))
+    unmap (list_entry (list_pop_front (mmaps), struct mmap, elem));
+}
+
+// M의 페이지를 전부 떼어내고 (고친 건 파일에 씀) 파일을 닫고 M을 해제
+static void
+unmap (struct mmap *m)
+{
+  size_t i;
+
+  for (i = 0; i < m->page_cnt; i++)
+    page_remove (m->base + i * PGSIZE);
+  lock_acquire (&file_lock);
+  file_close (m->file);
+  lock_release (&file_lock);
+  free (m);
+}
@@ -0,0 +1,17 @@
+#ifndef VM_MMAP_H
+#define VM_MMAP_H
+
+#include <stdbool.h>
+
+struct file;
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 파일 매핑 (mmap, munmap)
+// 파일을 유저 주소에 페이지 단위로 붙이고, 접근할 때 보조 페이지 테이블이 파일에서 채움
+typedef int mapid_t;
+#define MAP_FAILED ((mapid_t) -1)
+
+mapid_t mmap_map (struct file *, void *addr);
+bool mmap_unmap (mapid_t);
+void mmap_exit (void);
+
+#endif /* vm/mmap.h */
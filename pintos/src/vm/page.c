@@ -0,0 +1,796 @@
+#include "vm/page.h"
+#include <debug.h>
+#include <string.h>
+#include "filesys/file.h"
+#include "threads/malloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/pagedir.h"
+#include "userprog/process.h"
+#include "userprog/syscall.h"
+#include "vm/frame.h"
+#include "vm/swap.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// load()는 세그먼트를 읽지 않고 페이지마다 struct page만 등록해 둠
+// 처음 접근하면 page_fault() -> page_in()에서 프레임을 받아 채우고 매핑
+// 파일 페이지는 주변 FAULT_AROUND_PAGES개 중 아직 안 올라온 것도 같이 읽음
+// (순서대로 실행되는 코드는 fault 한 번에 여러 페이지, 메모리가 모자라면 생략)
+// 프레임이 모자라면 vm/frame.c가 다른 페이지를 골라 page_out()으로 내보냄
+// - 안 고친 파일/0 페이지는 그냥 버림 (다시 파일에서 읽거나 0으로)
+// - 고친 페이지, 스왑에서 온 페이지는 스왑에 씀
+// - mmap 페이지는 고쳤으면 스왑 대신 원래 파일에 씀 (munmap, 종료할 때도)
+// 스택은 처음에 한 페이지만, esp 근처에서 fault가 나면 USER_STACK_MAX까지 0 페이지를 붙여줌
+// (유저 스레드 스택도 같은 식으로 자기 자리 안에서 UTHREAD_STACK_SIZE까지)
+// 실행 파일의 읽기 전용 페이지(코드)는 같은 파일을 실행하는 프로세스끼리 프레임 하나를 같이 씀 (vm/frame.c)
+// fork()한 자식은 부모의 프레임을 읽기 전용으로 같이 매핑하고, 쓰려고 할 때 복사 (copy-on-write)
+// 0 페이지도 읽기만 하는 동안은 0 프레임 하나를 같이 매핑 (BSS의 큰 배열은 쓴 페이지만 프레임을 씀)
+// 파일/스왑을 읽고 쓰는 동안은 vm_lock을 놓음 (다른 프로세스의 fault는 기다리지 않음)
+// -> 그동안 그 페이지는 busy, 다른 스레드는 io_done에서 기다렸다가 테이블에서 다시 찾음
+// 파일 I/O는 file_lock 안에서, file_lock을 잡은 채로 vm_lock을 잡는 곳은 없음
+
+/* Fault-around window, in pages.  Must be a power of 2. */
+#define FAULT_AROUND_PAGES 8
+
+/* How far below the stack pointer an access may be and still
+   grow the stack.  PUSHA writes 32 bytes below ESP before
+   moving it. */
+#define STACK_SLOP 32
+
+struct lock vm_lock;            /* 모든 보조 페이지 테이블과 page-in 보호. */
+static struct condition io_done; /* 어떤 페이지의 busy가 풀림 (vm_lock과 같이). */
+
+static struct page *page_lookup (const void *upage);
+static struct page *page_lookup_idle (const void *upage);
+static void page_unbusy (struct page *);
+static bool page_add (struct page *);
+static bool page_load (struct page *, bool may_evict);
+static bool is_text (const struct page *);
+static bool map_zero (struct page *);
+static void fault_around (const struct page *);
+static bool is_stack_access (const void *uaddr, const void *esp);
+static bool share_frame (struct page *parent, struct page *child);
+static hash_hash_func page_hash;
+static hash_less_func page_less;
+static void page_release (struct page *);
+static hash_action_func page_destroy;
+
+void
+page_init (void)
+{
+  lock_init (&vm_lock);
+  cond_init (&io_done);
+}
+
+// 프로세스의 보조 페이지 테이블 (유저 스레드는 leader 것을 같이 씀)
+static struct hash *
+page_table (void)
+{
+  return &thread_current ()->leader->pages;
+}
+
+static uint32_t *
+page_dir (void)
+{
+  return thread_current ()->leader->pagedir;
+}
+
+/* Initializes the current process's supplemental page table.
+   Returns false if memory allocation fails. */
+bool
+page_table_init (void)
+{
+  return hash_init (page_table (), page_hash, page_less, NULL);
+}
+
+/* Frees every page in the current process's supplemental page
+   table, along with the frames of resident pages.  Must be
+   called before pagedir_destroy().  Does nothing if the table
+   was never initialized. */
+void
+page_table_destroy (void)
+{
+  lock_acquire (&vm_lock);
+  hash_destroy (page_table (), page_destroy);
+  lock_release (&vm_lock);
+}
+
+/* Registers UPAGE to be filled on first access with READ_BYTES
+   bytes from FILE at offset OFS, followed by zeros.  Returns
+   false if UPAGE is already registered or memory allocation
+   fails. */
+bool
+page_add_file (void *upage, struct file *file, off_t ofs,
+               uint32_t read_bytes, bool writable)
+{
+  struct page *p;
+
+  ASSERT (read_bytes <= PGSIZE);
+  if (read_bytes == 0)
+    return page_add_zero (upage, writable);
+
+  p = malloc (sizeof *p);
+  if (p == NULL)
+    return false;
+  p->upage = upage;
+  p->writable = writable;
+  p->type = PAGE_FILE;
+  p->file = file;
+  p->file_ofs = ofs;
+  p->read_bytes = read_bytes;
+  return page_add (p);
+}
+
+/* Registers UPAGE to be zero-filled on first access. */
+bool
+page_add_zero (void *upage, bool writable)
+{
+  struct page *p = malloc (sizeof *p);
+  if (p == NULL)
+    return false;
+  p->upage = upage;
+  p->writable = writable;
+  p->type = PAGE_ZERO;
+  p->file = NULL;
+  p->file_ofs = 0;
+  p->read_bytes = 0;
+  return page_add (p);
+}
+
+/* Registers UPAGE as a writable view of READ_BYTES bytes of
+   FILE at offset OFS, followed by zeros.  Unlike page_add_file(),
+   changes are written back to FILE when the page is evicted or
+   removed. */
+bool
+page_add_mmap (void *upage, struct file *file, off_t ofs,
+               uint32_t read_bytes)
+{
+  struct page *p;
+
+  ASSERT (read_bytes > 0 && read_bytes <= PGSIZE);
+
+  p = malloc (sizeof *p);
+  if (p == NULL)
+    return false;
+  p->upage = upage;
+  p->writable = true;
+  p->type = PAGE_MMAP;
+  p->file = file;
+  p->file_ofs = ofs;
+  p->read_bytes = read_bytes;
+  return page_add (p);
+}
+
+/* Removes UPAGE from the current process's supplemental page
+   table and unmaps it, writing a modified mmap page back to its
+   file first.  Does nothing if UPAGE is not registered. */
+void
+page_remove (void *upage)
+{
+  struct page *p;
+
+  lock_acquire (&vm_lock);
+  p = page_lookup_idle (upage);
+  if (p != NULL)
+    {
+      hash_delete (page_table (), &p->elem);
+      page_release (p);
+    }
+  lock_release (&vm_lock);
+}
+
+// P를 현재 프로세스의 테이블에 넣음, 이미 있는 주소면 P를 해제하고 false
+static bool
+page_add (struct page *p)
+{
+  bool success;
+
+  ASSERT (pg_ofs (p->upage) == 0);
+  ASSERT (is_user_vaddr (p->upage));
+
+  p->frame = NULL;
+  p->pagedir = page_dir ();
+  p->swap_slot = SWAP_NONE;
+  p->busy = false;
+  lock_acquire (&vm_lock);
+  success = hash_insert (page_table (), &p->elem) == NULL;
+  lock_release (&vm_lock);
+  if (!success)
+    free (p);
+  return success;
+}
+
+/* Copies the supplemental page table of PARENT, which must be
+   blocked, into the current process's, for fork().  Resident
+   pages share their frames read-only with the parent until one
+   side writes (see page_copy_on_write()).  Pages read from
+   PARENT's executable are read from EXEC_FILE instead, and
+   swapped-out pages share their swap slot.  Memory mappings are
+   not inherited.  Returns false if memory runs out, in which
+   case the caller destroys the partial copy. */
+bool
+page_table_fork (struct thread *parent, struct file *exec_file)
+{
+  struct hash_iterator i;
+  bool success = true;
+
+  lock_acquire (&vm_lock);
+  // 부모 페이지 중 다른 프로세스가 내보내는 중인 게 있으면 끝날 때까지 기다렸다가 처음부터
+  // (기다리는 동안 테이블이 바뀔 수 있음, 다 끝난 뒤에는 vm_lock을 놓지 않고 복사)
+  for (;;)
+    {
+      hash_first (&i, &parent->pages);
+      while (hash_next (&i))
+        if (hash_entry (hash_cur (&i), struct page, elem)->busy)
+          break;
+      if (hash_cur (&i) == NULL)
+        break;
+      cond_wait (&io_done, &vm_lock);
+    }
+
+  hash_first (&i, &parent->pages);
+  while (success && hash_next (&i))
+    {
+      struct page *p = hash_entry (hash_cur (&i), struct page, elem);
+      struct page *c;
+
+      if (p->type == PAGE_MMAP)
+        continue;
+      c = malloc (sizeof *c);
+      if (c == NULL)
+        {
+          success = false;
+          break;
+        }
+      *c = *p;
+      c->frame = NULL;
+      c->pagedir = page_dir ();
+      c->swap_slot = SWAP_NONE;
+      if (c->file != NULL)
+        c->file = exec_file;
+      hash_insert (page_table (), &c->elem);
+
+      // 스왑에 있는 페이지는 슬롯을 같이 씀 (각자 올릴 때 자기 프레임으로 읽음)
+      if (p->frame == NULL && p->type == PAGE_SWAP)
+        c->swap_slot = swap_dup (p->swap_slot);
+      else if (p->frame != NULL)
+        success = share_frame (p, c);
+    }
+  lock_release (&vm_lock);
+  return success;
+}
+
+/* Brings in the page containing user address UADDR, if the
+   current process has registered one there.  WRITE says whether
+   the faulting access was a write: a zero page that is only
+   read is mapped read-only to the shared zero frame instead of
+   a frame of its own.  Returns true if the page is now
+   resident, false if UADDR is not part of the process's address
+   space or memory is exhausted.  Called from page_fault(), for
+   both user and kernel accesses. */
+bool
+page_in (const void *uaddr, bool write)
+{
+  struct page *p;
+  bool success = false;
+
+  lock_acquire (&vm_lock);
+  p = page_lookup_idle (pg_round_down (uaddr));
+  if (p != NULL)
+    {
+      // 같은 프로세스의 다른 스레드가 먼저 올렸을 수도 있음
+      if (p->frame != NULL)
+        success = true;
+      else if (p->type == PAGE_ZERO && !write)
+        success = map_zero (p);
+      else
+        success = page_load (p, true);
+      if (success && (p->type == PAGE_FILE || p->type == PAGE_MMAP))
+        fault_around (p);
+    }
+  lock_release (&vm_lock);
+  return success;
+}
+
+/* Grows the current process's stack to cover user address
+   UADDR, if UADDR looks like a stack access given the user stack
+   pointer ESP: at most STACK_SLOP bytes below ESP, and either
+   within USER_STACK_MAX of PHYS_BASE or inside the stack slot
+   of one of the process's user threads (see uthread_create()).
+   Returns true if the page is now
+   resident.  Called from page_fault() after page_in() fails. */
+bool
+page_grow_stack (const void *uaddr, const void *esp)
+{
+  if (!is_stack_access (uaddr, esp))
+    return false;
+
+  // 같은 프로세스의 다른 스레드가 먼저 늘렸으면 등록은 실패하지만 page_in()은 성공
+  page_add_zero (pg_round_down (uaddr), true);
+  return page_in (uaddr, true);
+}
+
+/* Handles a write fault at user address UADDR on a page that is
+   mapped read-only only because its frame is shared, by fork()
+   or as the zero frame.  Gives the page a private copy of the
+   frame, or just makes the mapping writable if no other page
+   shares the frame any more.
+   Returns false if the page is really read-only or memory is
+   exhausted.  Called from page_fault(). */
+bool
+page_copy_on_write (const void *uaddr)
+{
+  struct page *p;
+  struct frame *old;
+  bool success = false;
+
+  lock_acquire (&vm_lock);
+  p = page_lookup_idle (pg_round_down (uaddr));
+  if (p == NULL || !p->writable)
+    goto done;
+
+  old = p->frame;
+  if (old == NULL)
+    {
+      // 그 사이에 내보내짐 -> 다시 실행하면 not-present fault로 올라옴
+      success = true;
+      goto done;
+    }
+  if (frame_shared (old) || old == frame_zero ())
+    {
+      // 새 프레임을 받다가 다른 페이지를 내보내면 vm_lock을 놓음
+      // -> 그동안 P가 busy라 OLD는 내보내지지도 합쳐지지도 않음 (0 프레임은 아예 안 내보냄)
+      struct frame *f;
+
+      p->busy = true;
+      f = frame_alloc (false);
+      if (f == NULL)
+        {
+          page_unbusy (p);
+          goto done;
+        }
+      memcpy (f->kpage, old->kpage, PGSIZE);
+      pagedir_clear_page (p->pagedir, p->upage);
+      frame_detach (old, p);
+      frame_attach (f, p);
+      page_unbusy (p);
+    }
+  else
+    pagedir_clear_page (p->pagedir, p->upage);
+  success = pagedir_set_page (p->pagedir, p->upage, p->frame->kpage, true);
+
+ done:
+  lock_release (&vm_lock);
+  return success;
+}
+
+/* Returns true if the current process may access user address
+   UADDR, for writing if WRITE is true, without being killed:
+   either UADDR is mapped, or it will be brought in or the stack
+   grown on fault.  Used to check user buffers before the kernel
+   touches them, so must be called from a system call. */
+bool
+page_accessible (const void *uaddr, bool write)
+{
+  void *upage = pg_round_down (uaddr);
+  struct page *p;
+  bool ok;
+
+  lock_acquire (&vm_lock);
+  p = page_lookup (upage);
+  if (p != NULL)
+    ok = !write || p->writable;
+  else if (pagedir_get_page (page_dir (), upage) != NULL)
+    {
+      /* Pages mapped outside the table: shared memory, the
+         uring page, the time page. */
+      ok = !write || pagedir_is_writable (page_dir (), upage);
+    }
+  else
+    ok = is_stack_access (uaddr, thread_current ()->user_esp);
+  lock_release (&vm_lock);
+  return ok;
+}
+
+static struct page *
+page_lookup (const void *upage)
+{
+  struct page key;
+  struct hash_elem *e;
+
+  key.upage = (void *) upage;
+  e = hash_find (page_table (), &key.elem);
+  return e != NULL ? hash_entry (e, struct page, elem) : NULL;
+}
+
+// UPAGE의 페이지를 찾음, busy면 I/O가 끝날 때까지 기다렸다가 다시 찾음 (vm_lock)
+// (기다리는 동안 vm_lock을 놓으니까 그 사이에 페이지가 빠졌을 수도 있음)
+static struct page *
+page_lookup_idle (const void *upage)
+{
+  struct page *p;
+
+  while ((p = page_lookup (upage)) != NULL && p->busy)
+    cond_wait (&io_done, &vm_lock);
+  return p;
+}
+
+// P의 I/O가 끝났다고 알리고 기다리던 스레드를 깨움 (vm_lock)
+static void
+page_unbusy (struct page *p)
+{
+  p->busy = false;
+  cond_broadcast (&io_done, &vm_lock);
+}
+
+// 프레임을 하나 받아서 P의 내용을 채우고 매핑 (vm_lock)
+// MAY_EVICT가 false면 빈 프레임이 없을 때 다른 페이지를 내보내지 않고 실패
+// 읽는 동안은 P를 busy로 두고 vm_lock을 놓음 (프레임은 아직 P에 안 붙어 있어서 아무도 안 건드림)
+static bool
+page_load (struct page *p, bool may_evict)
+{
+  struct frame *f;
+  uint8_t *kpage;
+  bool ok = true;
+
+  ASSERT (p->frame == NULL && !p->busy);
+
+  // 같은 실행 파일의 같은 코드 페이지가 다른 프로세스에 올라와 있으면 그 프레임을 같이 매핑
+  if (is_text (p))
+    {
+      f = frame_find_text (file_get_inode (p->file), p->file_ofs,
+                           p->read_bytes);
+      // 내보내는 중인 프레임이면 따로 읽음
+      if (f != NULL && !frame_busy (f))
+        {
+          if (!pagedir_set_page (p->pagedir, p->upage, f->kpage, false))
+            return false;
+          frame_attach (f, p);
+          return true;
+        }
+    }
+
+  p->busy = true;
+  f = (may_evict ? frame_alloc : frame_try_alloc) (p->type == PAGE_ZERO);
+  if (f == NULL)
+    {
+      page_unbusy (p);
+      return false;
+    }
+  kpage = f->kpage;
+
+  if (p->type != PAGE_ZERO)
+    {
+      lock_release (&vm_lock);
+      if (p->type == PAGE_SWAP)
+        {
+          ASSERT (p->swap_slot != SWAP_NONE);
+          swap_read (p->swap_slot, kpage);
+        }
+      else
+        {
+          lock_acquire (&file_lock);
+          ok = (file_read_at (p->file, kpage, p->read_bytes, p->file_ofs)
+                == (off_t) p->read_bytes);
+          lock_release (&file_lock);
+          memset (kpage + p->read_bytes, 0, PGSIZE - p->read_bytes);
+        }
+      lock_acquire (&vm_lock);
+    }
+
+  if (!ok || !pagedir_set_page (p->pagedir, p->upage, kpage, p->writable))
+    {
+      frame_free (f);
+      page_unbusy (p);
+      return false;
+    }
+  if (p->type == PAGE_SWAP)
+    {
+      // 슬롯은 바로 비움, 다음에 내보낼 때는 dirty와 상관없이 다시 씀
+      swap_free (p->swap_slot);
+      p->swap_slot = SWAP_NONE;
+    }
+  frame_attach (f, p);
+  if (is_text (p))
+    frame_add_text (f, file_get_inode (p->file), p->file_ofs, p->read_bytes);
+  page_unbusy (p);
+  return true;
+}
+
+// 아직 안 쓴 0 페이지 P를 모든 프로세스가 같이 쓰는 0 프레임에 읽기 전용으로 매핑 (vm_lock)
+// 쓰려고 하면 page_copy_on_write()가 자기 프레임을 줌
+static bool
+map_zero (struct page *p)
+{
+  struct frame *zero = frame_zero ();
+
+  if (!pagedir_set_page (p->pagedir, p->upage, zero->kpage, false))
+    return false;
+  frame_attach (zero, p);
+  return true;
+}
+
+// P가 실행 파일의 읽기 전용 페이지라 다른 프로세스와 프레임을 같이 쓸 수 있나
+static bool
+is_text (const struct page *p)
+{
+  return p->type == PAGE_FILE && !p->writable;
+}
+
+// P를 내보낼 때 스왑에 써야 하나 (이미 pagedir_clear_page()한 뒤여도 dirty 비트는 남아있음)
+static bool
+needs_swap (struct page *p)
+{
+  return (p->type == PAGE_SWAP
+          || (p->type != PAGE_MMAP && pagedir_is_dirty (p->pagedir, p->upage)));
+}
+
+// 프레임 F를 매핑한 페이지 중 스왑에 써야 하는 첫 페이지, 없으면 NULL
+// (fork나 합치기로 같이 쓰는 프레임이면 그런 페이지들이 슬롯 하나를 같이 씀)
+static struct page *
+swap_page (struct frame *f)
+{
+  struct list_elem *e;
+
+  for (e = list_begin (&f->pages); e != list_end (&f->pages); e = list_next (e))
+    {
+      struct page *p = list_entry (e, struct page, frame_elem);
+      if (needs_swap (p))
+        return p;
+    }
+  return NULL;
+}
+
+// 프레임 F의 내용을 스왑 슬롯 SLOT에 쓰기로 하고, 스왑에 써야 하는 페이지마다 SLOT의 참조를 하나씩 줌
+static void
+give_slot (struct frame *f, size_t slot)
+{
+  struct list_elem *e;
+  bool first = true;
+
+  for (e = list_begin (&f->pages); e != list_end (&f->pages); e = list_next (e))
+    {
+      struct page *p = list_entry (e, struct page, frame_elem);
+      if (needs_swap (p))
+        {
+          p->swap_slot = first ? slot : swap_dup (slot);
+          first = false;
+        }
+    }
+}
+
+// P의 고친 내용을 원래 파일에 씀 (mmap 페이지, vm_lock 없이)
+static void
+write_back (struct page *p, const void *kpage)
+{
+  lock_acquire (&file_lock);
+  file_write_at (p->file, kpage, p->read_bytes, p->file_ofs);
+  lock_release (&file_lock);
+}
+
+/* Evicts the pages in frames VICTIMS[0...CNT) from memory, which
+   must be called with vm_lock held.  Every page mapped to a
+   victim frame is unmapped, including pages that share it after
+   fork() or merging.  Pages that are unchanged since they were
+   read from a file or zero-filled are dropped.  Modified mmap
+   pages are written back to their file.  The other pages of a
+   frame are written to one swap slot that they share, with the
+   slots of different frames consecutive when possible.  vm_lock
+   is released while the pages are written, with the pages marked
+   busy.  Reorders VICTIMS so that the frames freed this way come
+   first, with no page attached, and returns their number.  A
+   frame that cannot be written because swap is full stays mapped
+   by all its pages. */
+size_t
+page_out (struct frame **victims, size_t cnt)
+{
+  size_t swap_cnt = 0, freed = 0, slot, i;
+  struct list_elem *e;
+
+  // 내용을 쓰는 동안 아무도 못 고치게 먼저 전부 매핑 해제 (dirty 비트는 남아있음)
+  for (i = 0; i < cnt; i++)
+    {
+      struct list *pages = &victims[i]->pages;
+      for (e = list_begin (pages); e != list_end (pages); e = list_next (e))
+        {
+          struct page *p = list_entry (e, struct page, frame_elem);
+          pagedir_clear_page (p->pagedir, p->upage);
+          p->busy = true;
+        }
+      if (swap_page (victims[i]) != NULL)
+        swap_cnt++;
+    }
+
+  // 프레임마다 슬롯 하나, 가능하면 연속으로, 못 받은 프레임의 페이지는 SWAP_NONE 그대로
+  slot = swap_cnt > 1 ? swap_alloc (swap_cnt) : SWAP_NONE;
+  for (i = 0; i < cnt; i++)
+    if (swap_page (victims[i]) != NULL)
+      {
+        size_t s = slot != SWAP_NONE ? slot++ : swap_alloc (1);
+        if (s != SWAP_NONE)
+          give_slot (victims[i], s);
+      }
+
+  // 전부 busy라 쓰는 동안 매핑도 타입도 안 바뀜
+  lock_release (&vm_lock);
+  for (i = 0; i < cnt; i++)
+    {
+      struct list *pages = &victims[i]->pages;
+      struct page *sp = swap_page (victims[i]);
+
+      if (sp != NULL && sp->swap_slot != SWAP_NONE)
+        swap_write (sp->swap_slot, victims[i]->kpage);
+      for (e = list_begin (pages); e != list_end (pages); e = list_next (e))
+        {
+          struct page *p = list_entry (e, struct page, frame_elem);
+          if (p->type == PAGE_MMAP && pagedir_is_dirty (p->pagedir, p->upage))
+            write_back (p, victims[i]->kpage);
+        }
+    }
+  lock_acquire (&vm_lock);
+
+  for (i = 0; i < cnt; i++)
+    {
+      struct frame *f = victims[i];
+      struct page *sp = swap_page (f);
+      bool full = sp != NULL && sp->swap_slot == SWAP_NONE;
+      bool shared = frame_shared (f);
+
+      if (full)
+        {
+          // 스왑이 꽉 참 -> 다시 매핑, 고친 내용은 파일에 없으니 이제 스왑 페이지
+          // (같이 쓰던 프레임은 계속 읽기 전용, 쓰면 page_copy_on_write())
+          for (e = list_begin (&f->pages); e != list_end (&f->pages);
+               e = list_next (e))
+            {
+              struct page *p = list_entry (e, struct page, frame_elem);
+              p->busy = false;
+              if (needs_swap (p))
+                p->type = PAGE_SWAP;
+              pagedir_set_page (p->pagedir, p->upage, f->kpage,
+                                p->writable && !shared);
+            }
+          continue;
+        }
+      while (!list_empty (&f->pages))
+        {
+          struct page *p = list_entry (list_pop_front (&f->pages),
+                                       struct page, frame_elem);
+          p->busy = false;
+          if (needs_swap (p))
+            p->type = PAGE_SWAP;
+          p->frame = NULL;
+        }
+
+      victims[i] = victims[freed];
+      victims[freed++] = f;
+    }
+  cond_broadcast (&io_done, &vm_lock);
+  return freed;
+}
+
+/* Returns an identifier for the user page containing UADDR that
+   stays the same while the page is evicted and brought back in a
+   different frame, or NULL if UADDR is not in the supplemental
+   page table. */
+const void *
+page_futex_key (const void *uaddr)
+{
+  struct page *p;
+
+  lock_acquire (&vm_lock);
+  p = page_lookup (pg_round_down (uaddr));
+  lock_release (&vm_lock);
+  return p;
+}
+
+// 부모 페이지 PARENT의 프레임을 자식 페이지 CHILD와 같이 쓰도록 둘 다 읽기 전용으로 매핑 (vm_lock)
+// 부모가 고친 페이지는 이제 파일/0에서 다시 만들 수 없으니 둘 다 PAGE_SWAP으로
+// (다시 매핑하면 dirty 비트가 지워짐)
+static bool
+share_frame (struct page *parent, struct page *child)
+{
+  struct frame *f = parent->frame;
+
+  if (pagedir_is_dirty (parent->pagedir, parent->upage))
+    parent->type = PAGE_SWAP;
+  child->type = parent->type;
+
+  pagedir_clear_page (parent->pagedir, parent->upage);
+  pagedir_set_page (parent->pagedir, parent->upage, f->kpage, false);
+  if (!pagedir_set_page (child->pagedir, child->upage, f->kpage, false))
+    return false;
+  frame_attach (f, child);
+  return true;
+}
+
+// UADDR가 유저 스택 ESP로 보아 스택을 늘릴 만한 접근인지
+// (ESP보다 STACK_SLOP 넘게 아래면 그냥 잘못된 접근)
+// 메인 스택 영역이거나, 쓰고 있는 유저 스레드 스택 자리 안이어야 함 (자리마다 UTHREAD_STACK_SIZE까지)
+static bool
+is_stack_access (const void *uaddr, const void *esp)
+{
+  const uint8_t *addr = uaddr;
+  const uint8_t *main_bottom = (const uint8_t *) PHYS_BASE - USER_STACK_MAX;
+  size_t slot;
+
+  if (!is_user_vaddr (uaddr) || (uintptr_t) uaddr + STACK_SLOP < (uintptr_t) esp)
+    return false;
+  if (addr >= main_bottom)
+    return true;
+  if (addr < UTHREAD_STACK_TOP (UTHREAD_MAX))
+    return false;
+  slot = (main_bottom - 1 - addr) / UTHREAD_STACK_SIZE;
+  return (thread_current ()->leader->uthread_stacks & (1u << slot)) != 0;
+}
+
+// P 주변(정렬된 FAULT_AROUND_PAGES개)의 같은 파일 페이지 중 아직 안 올라온 것을 미리 읽음
+// 미리 읽는 건 덤이라 실패해도 상관없음 (프레임이 없으면 그만둠)
+// 읽을 때마다 vm_lock을 놓아서 P가 그 사이에 없어질 수 있으니 필요한 건 먼저 복사해 둠
+static void
+fault_around (const struct page *p)
+{
+  uint8_t *start = (uint8_t *) ((uintptr_t) p->upage
+                                & ~(FAULT_AROUND_PAGES * PGSIZE - 1));
+  void *upage = p->upage;
+  enum page_type type = p->type;
+  struct file *file = p->file;
+  int i;
+
+  for (i = 0; i < FAULT_AROUND_PAGES; i++)
+    {
+      struct page *q = page_lookup (start + i * PGSIZE);
+      if (q != NULL && q->upage != upage && q->frame == NULL && !q->busy
+          && q->type == type && q->file == file
+          && !page_load (q, false))
+        break;
+    }
+}
+
+static unsigned
+page_hash (const struct hash_elem *e, void *aux UNUSED)
+{
+  const struct page *p = hash_entry (e, struct page, elem);
+  return hash_bytes (&p->upage, sizeof p->upage);
+}
+
+static bool
+page_less (const struct hash_elem *a, const struct hash_elem *b,
+           void *aux UNUSED)
+{
+  return (hash_entry (a, struct page, elem)->upage
+          < hash_entry (b, struct page, elem)->upage);
+}
+
+// P의 매핑, 프레임, 스왑 슬롯을 해제하고 P도 해제 (vm_lock, 테이블에서는 이미 뺀 상태)
+// 고친 mmap 페이지는 먼저 파일에 씀 (쓰는 동안은 busy로 두고 vm_lock을 놓음)
+static void
+page_release (struct page *p)
+{
+  // 다른 프로세스가 내보내는 중이면 끝날 때까지 (테이블에서 빠져 있어도 프레임으로는 보임)
+  while (p->busy)
+    cond_wait (&io_done, &vm_lock);
+  if (p->frame != NULL)
+    {
+      pagedir_clear_page (p->pagedir, p->upage);
+      if (p->type == PAGE_MMAP && pagedir_is_dirty (p->pagedir, p->upage))
+        {
+          p->busy = true;
+          lock_release (&vm_lock);
+          write_back (p, p->frame->kpage);
+          lock_acquire (&vm_lock);
+        }
+      frame_detach (p->frame, p);
+    }
+  else if (p->swap_slot != SWAP_NONE)
+    swap_free (p->swap_slot);
+  free (p);
+}
+
+// page_table_destroy()에서 페이지마다 호출
+static void
+page_destroy (struct hash_elem *e, void *aux UNUSED)
+{
+  page_release (hash_entry (e, struct page, elem));
+}
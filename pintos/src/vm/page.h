@@ -0,0 +1,75 @@
+#ifndef VM_PAGE_H
+#define VM_PAGE_H
+
+#include <hash.h>
+#include <list.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "filesys/off_t.h"
+#include "threads/synch.h"
+
+struct frame;
+struct thread;
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 보조 페이지 테이블 (supplemental page table)
+// 프로세스마다 하나 (leader의 pages), 유저 페이지 하나당 struct page 하나
+// 처음 접근해서 page fault가 날 때 여기를 보고 내용을 채워 넣음
+
+/* Where a page's contents come from the first time it is
+   touched. */
+enum page_type
+  {
+    PAGE_ZERO,                  /* 전부 0 (BSS, 스택). */
+    PAGE_FILE,                  /* 파일에서 읽고 나머지는 0 (ELF 세그먼트). */
+    PAGE_MMAP,                  /* PAGE_FILE과 같지만 고친 내용은 파일에 다시 씀 (mmap). */
+    PAGE_SWAP                   /* 스왑 슬롯에 있음 (올라와 있으면 내보낼 때 스왑에 써야 함). */
+  };
+
+struct page
+  {
+    void *upage;                /* 유저 가상 주소 (페이지 정렬), hash 키. */
+    bool writable;              /* 유저가 쓸 수 있나. */
+    enum page_type type;
+    struct frame *frame;        /* 올라와 있으면 프레임, 아니면 NULL. */
+    struct list_elem frame_elem; /* frame의 pages 요소. */
+    uint32_t *pagedir;          /* 매핑된 page directory (프로세스의 leader 것). */
+
+    /* PAGE_FILE, PAGE_MMAP. */
+    struct file *file;          /* 읽을 파일. */
+    off_t file_ofs;             /* 파일 오프셋. */
+    uint32_t read_bytes;        /* 읽을 바이트 수, 나머지는 0. */
+
+    /* PAGE_SWAP. */
+    size_t swap_slot;           /* 내용이 있는 슬롯, 올라와 있으면 SWAP_NONE. */
+
+    bool busy;                  /* 읽거나 쓰는 중 (vm_lock 없이 I/O), 끝날 때까지 아무도 못 건드림. */
+
+    struct hash_elem elem;      /* thread의 pages 요소. */
+  };
+
+/* Protects every supplemental page table, the frame table and
+   swap slot allocation.  Never held across disk or swap I/O: a
+   page being read or written is marked busy and vm_lock is
+   released, so file_lock is only ever taken without it.  May be
+   taken while holding futex_lock or a process's proc_lock. */
+extern struct lock vm_lock;
+
+void page_init (void);
+bool page_table_init (void);
+void page_table_destroy (void);
+bool page_table_fork (struct thread *parent, struct file *exec_file);
+
+bool page_add_file (void *upage, struct file *, off_t ofs,
+                    uint32_t read_bytes, bool writable);
+bool page_add_zero (void *upage, bool writable);
+bool page_add_mmap (void *upage, struct file *, off_t ofs,
+                    uint32_t read_bytes);
+void page_remove (void *upage);
+bool page_in (const void *uaddr, bool write);
+bool page_grow_stack (const void *uaddr, const void *esp);
+bool page_copy_on_write (const void *uaddr);
+bool page_accessible (const void *uaddr, bool write);
+const void *page_futex_key (const void *uaddr);
+size_t page_out (struct frame **, size_t cnt);
+
+#endif /* vm/page.h */
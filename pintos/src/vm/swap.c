@@ -0,0 +1,110 @@
+#include "vm/swap.h"
+#include <bitmap.h>
+#include <debug.h>
+#include <stdio.h>
+#include "devices/block.h"
+#include "threads/malloc.h"
+#include "threads/vaddr.h"
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️
+// 슬롯 하나 = 섹터 SECTORS_PER_SLOT개 = 한 페이지
+// fork()한 자식은 부모의 스왑된 페이지를 읽지 않고 슬롯을 같이 씀 (참조 개수)
+// 슬롯 할당/해제는 호출하는 쪽 (vm/page.c의 vm_lock) 몫, 읽고 쓰는 건 vm_lock 없이
+
+#define SECTORS_PER_SLOT (PGSIZE / BLOCK_SECTOR_SIZE)
+
+static struct block *swap_block;        /* 스왑 장치, 없으면 NULL. */
+static struct bitmap *swap_slots;       /* 사용 중인 슬롯. */
+static uint16_t *swap_refs;             /* 슬롯마다 참조 개수. */
+
+/* Finds the swap device.  Without one, swap_alloc() always
+   fails, so only clean pages can be evicted. */
+void
+swap_init (void)
+{
+  size_t slot_cnt;
+
+  swap_block = block_get_role (BLOCK_SWAP);
+  if (swap_block == NULL)
+    return;
+  slot_cnt = block_size (swap_block) / SECTORS_PER_SLOT;
+  swap_slots = bitmap_create (slot_cnt);
+  swap_refs = malloc (slot_cnt * sizeof *swap_refs);
+  if (swap_slots == NULL || swap_refs == NULL)
+    {
+      printf ("swap: out of memory, swap disabled\n");
+      swap_block = NULL;
+    }
+}
+
+/* Allocates CNT consecutive swap slots and returns the first
+   one, or SWAP_NONE if there is no such run of free slots or
+   the swap device cannot guarantee room to write them (a
+   compressed device out of memory).
+   Consecutive slots let a cluster of evicted pages be written
+   in one sequential sweep of the disk. */
+size_t
+swap_alloc (size_t cnt)
+{
+  size_t slot, i;
+
+  if (swap_block == NULL)
+    return SWAP_NONE;
+  slot = bitmap_scan_and_flip (swap_slots, 0, cnt, false);
+  if (slot == BITMAP_ERROR)
+    return SWAP_NONE;
+  if (!block_reserve (swap_block, slot * SECTORS_PER_SLOT,
+                      cnt * SECTORS_PER_SLOT))
+    {
+      bitmap_set_multiple (swap_slots, slot, cnt, false);
+      return SWAP_NONE;
+    }
+  for (i = 0; i < cnt; i++)
+    swap_refs[slot + i] = 1;
+  return slot;
+}
+
+/* Adds a reference to SLOT, so that two pages with the same
+   contents can share it, and returns SLOT. */
+size_t
+swap_dup (size_t slot)
+{
+  ASSERT (bitmap_test (swap_slots, slot));
+  ASSERT (swap_refs[slot] < UINT16_MAX);
+  swap_refs[slot]++;
+  return slot;
+}
+
+/* Drops a reference to SLOT, freeing it with the last one. */
+void
+swap_free (size_t slot)
+{
+  ASSERT (bitmap_test (swap_slots, slot));
+  if (--swap_refs[slot] > 0)
+    return;
+  bitmap_reset (swap_slots, slot);
+  // 압축 스왑 (devices/zram.c)은 이걸 받고 메모리를 돌려줌
+  block_discard (swap_block, slot * SECTORS_PER_SLOT, SECTORS_PER_SLOT);
+}
+
+/* Writes the page at KPAGE to SLOT. */
+void
+swap_write (size_t slot, const void *kpage)
+{
+  size_t i;
+
+  for (i = 0; i < SECTORS_PER_SLOT; i++)
+    block_write (swap_block, slot * SECTORS_PER_SLOT + i,
+                 (const uint8_t *) kpage + i * BLOCK_SECTOR_SIZE);
+}
+
+/* Reads SLOT into the page at KPAGE. */
+void
+swap_read (size_t slot, void *kpage)
+{
+  size_t i;
+
+  for (i = 0; i < SECTORS_PER_SLOT; i++)
+    block_read (swap_block, slot * SECTORS_PER_SLOT + i,
+                (uint8_t *) kpage + i * BLOCK_SECTOR_SIZE);
+}
@@ -0,0 +1,17 @@
+#ifndef VM_SWAP_H
+#define VM_SWAP_H
+
+#include <stddef.h>
+
+/* No swap slot. */
+#define SWAP_NONE ((size_t) -1)
+
+// Ⓜ️Ⓜ️Ⓜ️Ⓜ️Ⓜ️ - 스왑 파티션 (BLOCK_SWAP)을 페이지 크기 슬롯으로 나눠 씀
+void swap_init (void);
+size_t swap_alloc (size_t cnt);
+size_t swap_dup (size_t slot);
+void swap_free (size_t slot);
+void swap_write (size_t slot, const void *kpage);
+void swap_read (size_t slot, void *kpage);
+
+#endif /* vm/swap.h */